@@ -0,0 +1,153 @@
+""" Loopback latency/throughput benchmark for get/set/pull/ParameterList.pull.
+
+    Starts CSP in-process, creates N local parameters (served by the local param server),
+    and mirrors them as remote parameters on our own address, so every remote operation
+    makes a full round trip through CSP routing and `param_serve()`.
+
+    Results are written as JSON, for trend tracking across PyCSH releases.
+    Run through `meson test --benchmark` (with `-Dbenchmarks=true`), or directly:
+        PYTHONPATH=<builddir> python3 benchmark/param_loopback.py --output results.json """
+
+from __future__ import annotations
+
+import sys as _sys
+import json as _json
+import time as _time
+import argparse as _argparse
+import platform as _platform
+from statistics import median as _median
+
+import pycsh
+
+
+def _percentile(sorted_samples: list[float], pct: float) -> float:
+    """ Nearest-rank percentile of already sorted samples. """
+    if not sorted_samples:
+        return 0.0
+    rank = max(1, min(len(sorted_samples), round(pct / 100 * len(sorted_samples))))
+    return sorted_samples[rank-1]
+
+
+def _measure(func, iterations: int) -> dict[str, float]:
+    """ Call `func` `iterations` times, and summarize the latency distribution in microseconds. """
+    samples: list[float] = []
+    failures = 0
+    start = _time.perf_counter()
+    for _ in range(iterations):
+        before = _time.perf_counter_ns()
+        try:
+            func()
+        except ConnectionError:
+            failures += 1
+            continue
+        samples.append((_time.perf_counter_ns() - before) / 1E3)
+    elapsed = _time.perf_counter() - start
+
+    samples.sort()
+    return {
+        'iterations': iterations,
+        'failures': failures,
+        'ops_per_s': (len(samples) / elapsed) if elapsed > 0 else 0.0,
+        'min_us': samples[0] if samples else 0.0,
+        'p50_us': _median(samples) if samples else 0.0,
+        'p90_us': _percentile(samples, 90),
+        'p99_us': _percentile(samples, 99),
+        'max_us': samples[-1] if samples else 0.0,
+    }
+
+
+def _create_params(node: int, count: int, array_size: int, first_id: int) -> tuple[list[pycsh.Parameter], list[pycsh.Parameter]]:
+    """ Create `count` local parameters, and remote mirrors of them on `node`.
+        The local parameters are added to the list, so the param server can find them,
+        and must be kept alive by the caller for as long as they are served. """
+    local: list[pycsh.Parameter] = []
+    remote: list[pycsh.Parameter] = []
+    for i in range(count):
+        param_id = first_id + i
+        name = f'bench_{array_size}_{param_id}'
+        local.append(pycsh.Parameter.new(param_id, name, pycsh.PARAM_TYPE_UINT32, pycsh.PM_TELEM, array_size=array_size).list_add())
+        remote.append(pycsh.list_add(node, array_size, param_id, name, pycsh.PARAM_TYPE_UINT32, pycsh.PM_TELEM))
+    return local, remote
+
+
+def run(node: int, param_counts: list[int], array_sizes: list[int], iterations: int, timeout: int) -> list[dict]:
+
+    results: list[dict] = []
+    served: list[pycsh.Parameter] = []  # Keeps the local parameters alive for the whole run.
+    first_id = 30000  # Stay clear of the IDs used by CSH itself.
+
+    for array_size in array_sizes:
+        for count in param_counts:
+            local, remote = _create_params(node, count, array_size, first_id)
+            served.extend(local)
+            first_id += count
+
+            value = 0 if array_size == 1 else [0] * array_size
+            single = remote[0]
+            param_list = pycsh.ParameterList(remote)
+
+            cases = {
+                'get': lambda: pycsh.get(single.name, node=node, timeout=timeout),
+                'set': lambda: pycsh.set(single.name, value, node=node, timeout=timeout, verbose=0),
+                'pull': lambda: pycsh.pull(node=node, timeout=timeout, include_mask=pycsh.PM_TELEM, verbose=0),
+                'ParameterList.pull': lambda: param_list.pull(node=node, timeout=timeout),
+            }
+
+            for operation, func in cases.items():
+                result = {
+                    'operation': operation,
+                    'param_count': count,
+                    'array_size': array_size,
+                }
+                result.update(_measure(func, iterations))
+                results.append(result)
+                print(f"{operation:>20} count={count:<5} array_size={array_size:<4} "
+                      f"p50={result['p50_us']:9.1f}us p99={result['p99_us']:9.1f}us {result['ops_per_s']:9.1f} ops/s", file=_sys.stderr)
+
+    return results
+
+
+def main() -> int:
+    parser = _argparse.ArgumentParser(description=__doc__, formatter_class=_argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--addr', type=int, default=4000, help='CSP address of this process, the parameters are served on this node.')
+    parser.add_argument('--zmq', type=str, default=None, help='Use a ZMQ interface to this zmqproxy server, instead of UDP loopback.')
+    parser.add_argument('--port', type=int, default=9620, help='UDP port used for the loopback interface.')
+    parser.add_argument('--param-counts', type=int, nargs='+', default=[1, 10, 100])
+    parser.add_argument('--array-sizes', type=int, nargs='+', default=[1, 8, 64])
+    parser.add_argument('--iterations', type=int, default=200)
+    parser.add_argument('--timeout', type=int, default=1000, help='Timeout in ms per transaction.')
+    parser.add_argument('--output', type=str, default=None, help='JSON file to write results to, defaults to stdout.')
+    args = parser.parse_args()
+
+    pycsh.init(quiet=1)
+    pycsh.csp_init()
+    if args.zmq:
+        pycsh.csp_add_zmq(args.addr, args.zmq, default=1)
+    else:
+        pycsh.csp_add_udp(args.addr, '127.0.0.1', default=1, listen_port=args.port, remote_port=args.port)
+
+    report = {
+        'pycsh_version': pycsh.VERSION,
+        'python_version': _platform.python_version(),
+        'machine': _platform.machine(),
+        'interface': 'zmq' if args.zmq else 'udp-loopback',
+        'timestamp': _time.time(),
+        'results': run(args.addr, args.param_counts, args.array_sizes, args.iterations, args.timeout),
+    }
+
+    if args.output:
+        with open(args.output, 'w') as fp:
+            _json.dump(report, fp, indent=2)
+    else:
+        _json.dump(report, _sys.stdout, indent=2)
+
+    failures = sum(result['failures'] for result in report['results'])
+    if failures > 0:
+        print(f"{failures} transaction(s) failed, results are not representative", file=_sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == '__main__':
+    _sys.exit(main())
@@ -0,0 +1,30 @@
+/*
+ * batch.h
+ *
+ * Batching of remote parameter writes, see `pycsh.batch()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <param/param.h>
+
+/**
+ * @brief Queue a remote write in the batch active on the calling thread, instead of pushing it immediately.
+ *
+ * Caller must hold the GIL.
+ *
+ * @param value Value buffer, as filled by `_pyval_to_param_valuebuf()`.
+ * @param host Destination the write would otherwise have been pushed to.
+ * @return 1 when queued, 0 when no batch is active, or -1 with an exception set.
+ */
+int pycsh_batch_add(const param_t * param, int offset, const void * value, int host);
+
+extern PyTypeObject BatchType;
+
+PyObject * pycsh_batch(PyObject * self, PyObject * args, PyObject * kwds);
@@ -0,0 +1,40 @@
+/*
+ * callback_filter.h
+ *
+ * Per-parameter filters, which decide whether a Parameter callback should be called, before the GIL is taken.
+ * See `Parameter.set_callback_filter()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <param/param.h>
+
+/**
+ * @brief Whether the callback of `param` should be called for the value just applied at `offset`.
+ *
+ * Remembers the value when it passes, so later values are compared to the last one the callback saw.
+ * Cheap when no filters exist. Does not require the GIL.
+ */
+bool pycsh_callback_filter_pass(const param_t * param, int offset);
+
+/**
+ * @brief Set (or replace) the filter of `param`. Passing no conditions removes it.
+ *
+ * @param on_change Only pass values which differ from the last passed value.
+ * @param deadband Only pass numeric values which differ by more than this from the last passed value.
+ * @param rel_deadband Like `deadband`, as a fraction of the last passed value.
+ * @param min_interval_ms Pass at most one value per this many milliseconds.
+ * @return 0 on success, -1 when out of memory.
+ */
+int pycsh_callback_filter_set(const param_t * param, bool on_change, double deadband, double rel_deadband, uint32_t min_interval_ms);
+
+/* Remove the filter of `param`, if any. */
+void pycsh_callback_filter_remove(const param_t * param);
+
+/* Number of values filtered out for `param`, since its filter was set. */
+uint64_t pycsh_callback_filter_filtered(const param_t * param);
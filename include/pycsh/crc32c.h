@@ -0,0 +1,39 @@
+/*
+ * crc32c.h
+ *
+ * CRC32C (Castagnoli), as used by CSP, using the SSE4.2 crc32 instruction when the CPU supports it.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <csp/csp.h>
+
+/**
+ * @brief CRC32C of `data`, same result as `csp_crc32_memory()`, but faster.
+ *
+ * Thread-safe, and does not require the GIL.
+ *
+ * @param crc 0 to start, or the result of a previous call to continue it (like `zlib.crc32()`).
+ */
+uint32_t pycsh_crc32c(uint32_t crc, const void * data, size_t len);
+
+/**
+ * @brief Drop-in replacement for `csp_crc32_verify()`.
+ *
+ * Verifies the big-endian CRC32C trailing `packet->data` (not covering the header, like CSP 1.x),
+ * and strips it from `packet->length` when it matches.
+ *
+ * @return CSP_ERR_NONE on success, CSP_ERR_CRC32 when the packet is too short or the CRC is wrong.
+ */
+int pycsh_crc32c_verify(csp_packet_t * packet);
+
+PyObject * pycsh_crc32(PyObject * self, PyObject * args, PyObject * kwds);
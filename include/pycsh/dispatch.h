@@ -0,0 +1,38 @@
+/*
+ * dispatch.h
+ *
+ * Deferred dispatch of Parameter callbacks to a dedicated thread, see `pycsh.callback_dispatch()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <param/param.h>
+
+/**
+ * @brief Queue the Python callback of `param` for the dispatcher thread, instead of calling it now.
+ *
+ * Only done when deferred dispatch is enabled, and the calling thread does not hold the GIL,
+ * so the router never waits for the GIL, while callbacks of values set from Python still run synchronously.
+ * Lock-free, and never blocks.
+ *
+ * @return true when the callback has been taken care of (queued or dropped), false when it should be called now.
+ */
+bool pycsh_dispatch_enqueue(const param_t * param, int offset);
+
+/**
+ * @brief Skip callbacks already queued for `param`, because its Parameter is being deleted.
+ *
+ * Must be called before `param` can be freed, so a later param_t at the same address
+ * doesn't receive callbacks queued for this one.
+ */
+void pycsh_dispatch_forget(const param_t * param);
+
+PyObject * pycsh_callback_dispatch(PyObject * self, PyObject * args, PyObject * kwds);
+PyObject * pycsh_callback_dispatch_stats(PyObject * self, PyObject * args, PyObject * kwds);
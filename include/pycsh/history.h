@@ -0,0 +1,33 @@
+/*
+ * history.h
+ *
+ * In-memory time-series of received parameter values, see `pycsh.history()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <param/param.h>
+
+/**
+ * @brief Append the current value of `param` to its history, if history is enabled for it.
+ *
+ * Should be called whenever a value is applied to `param`.
+ * Cheap when no history is enabled. Does not require the GIL.
+ */
+void pycsh_history_record(const param_t * param);
+
+/* Whether history is enabled for any parameters, see `pycsh_watch_enabled()` */
+bool pycsh_history_enabled(void);
+
+extern PyTypeObject ParameterHistoryType;
+
+PyObject * pycsh_history_enable(PyObject * self, PyObject * args, PyObject * kwds);
+PyObject * pycsh_history_disable(PyObject * self, PyObject * args);
+PyObject * pycsh_history(PyObject * self, PyObject * args, PyObject * kwds);
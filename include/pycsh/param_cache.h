@@ -0,0 +1,48 @@
+/*
+ * param_cache.h
+ *
+ * Binary on-disk cache of downloaded parameter lists, see `pycsh.list_download(cache=...)`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+/* Size of fingerprint buffers, including the terminating NUL. */
+#define PARAM_CACHE_FINGERPRINT_LEN 96
+
+/**
+ * @brief Identify the software running on `node`, for use as a cache fingerprint.
+ *
+ * Uses a single CSP ident request, which is far cheaper than downloading the list.
+ * This does not change when parameters are added without a software change (e.g. by APMs),
+ * so callers should append a list checksum when the node provides one, and limit the age of the cache.
+ * Blocks for up to `timeout`, so the GIL should be released by the caller.
+ *
+ * @return 0 on success, otherwise -1.
+ */
+int pycsh_param_cache_fingerprint(int node, int timeout, char * out, size_t out_len);
+
+/**
+ * @brief Save the parameters of `node` in the global list to `path`.
+ *
+ * Written to a temporary file first, so readers never see a partial cache.
+ *
+ * @return Number of parameters saved, or -1 with `errno` set.
+ */
+int pycsh_param_cache_save(const char * path, int node, const char * fingerprint);
+
+/**
+ * @brief Add the parameters cached in `path` to the global list, if the cache matches `node` and `fingerprint`.
+ *
+ * Parameters are added one by one with `param_list_add()`, as libparam has no bulk add,
+ * which scans the list for duplicates every time, so loading is O(N^2) in the size of the list.
+ * Caller must hold the GIL, and call `pycsh_param_index_invalidate()` when parameters were added.
+ *
+ * @param max_age_s Caches saved longer ago than this are stale, 0 for no limit.
+ * @return Number of parameters added, 0 when the cache is missing, stale or corrupt.
+ */
+int pycsh_param_cache_load(const char * path, int node, const char * fingerprint, unsigned int max_age_s);
@@ -0,0 +1,52 @@
+/*
+ * param_index.h
+ *
+ * Hash index of the global parameter list, keyed by (node, name) and (node, id).
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <param/param.h>
+
+/**
+ * @brief Drop-in replacement for `param_list_find_name()`.
+ *
+ * The index is rebuilt from the parameter list on the first lookup after `pycsh_param_index_invalidate()`.
+ * Misses fall back to scanning the list, so parameters added behind our back are still found.
+ * Caller must hold the GIL, or be running on a free-threaded build.
+ */
+const param_t * pycsh_param_index_find_name(int node, const char * name);
+
+/**
+ * @brief Drop-in replacement for `param_list_find_id()`, see `pycsh_param_index_find_name()`.
+ */
+const param_t * pycsh_param_index_find_id(int node, int id);
+
+/**
+ * @brief Mark the index as stale.
+ *
+ * Must be called whenever `param_t`s are removed from (or replaced in) the parameter list,
+ * before the next lookup, as hits are returned (and verified) by dereferencing the stored pointers.
+ * libparam offers no way to detect removals, so this is also required of APMs and other C code
+ * which calls `param_list_remove*()` or `param_list_destroy()` on listed parameters.
+ * PyCSH itself calls it from `list_forget()`, `list_download()`, `Parameter.list_add()`/`list_forget()`,
+ * its list slash commands, and after every slash command executed through Python.
+ * Caller must hold the GIL, or be running on a free-threaded build.
+ */
+void pycsh_param_index_invalidate(void);
+
+/**
+ * @brief Incremented by every `pycsh_param_index_invalidate()`.
+ *
+ * Allows holders of `param_t` pointers to detect that some may since have been destroyed.
+ */
+uint64_t pycsh_param_index_generation(void);
+
+PyObject * pycsh_param_index_stats(PyObject * self, PyObject * args, PyObject * kwds);
@@ -59,6 +59,11 @@ extern PyMethodDef Parameter_class_methods[2];
  */
 void Parameter_callback(const param_t * param, int offset);
 
+/**
+ * @brief Call the Python callback of the Parameter wrapping `param`, caller must hold the GIL.
+ */
+void Parameter_callback_invoke(const param_t * param, int offset);
+
 
 // Source: https://chat.openai.com
 /**
@@ -45,3 +45,5 @@ extern unsigned int slash_dfl_timeout;  // In milliseconds
 #define pycsh_dfl_timeout slash_dfl_timeout
 
 extern int pycsh_dfl_verbose;
+/* Maximum age in milliseconds of cached remote values, which may be read without pulling them. 0 to always pull. */
+extern unsigned int pycsh_dfl_max_age;
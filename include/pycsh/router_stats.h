@@ -0,0 +1,38 @@
+/*
+ * router_stats.h
+ *
+ * Counters for the CSP router thread started by `pycsh.csp_init()`, see `pycsh.router_stats()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Mark the calling thread as a router worker, must be called once from the thread itself. */
+void pycsh_router_worker_register(void);
+
+/**
+ * @brief Account for one `csp_route_work()` iteration of the calling router worker.
+ *
+ * @param start_us `pycsh_stats_now_us()` from before `csp_route_work()`.
+ * @param was_routed Whether a packet was routed, rather than the FIFO timing out.
+ */
+void pycsh_router_record_work(uint64_t start_us, bool was_routed);
+
+/**
+ * @brief Account for time spent in a Python Parameter callback, including waiting for the GIL.
+ *
+ * Only counted when called from a router worker, cheap to call from any other thread.
+ *
+ * @param start_us `pycsh_stats_now_us()` from before acquiring the GIL.
+ */
+void pycsh_router_record_callback(uint64_t start_us);
+
+PyObject * pycsh_router_stats(PyObject * self, PyObject * args, PyObject * kwds);
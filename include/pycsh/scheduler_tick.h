@@ -0,0 +1,28 @@
+/*
+ * scheduler_tick.h
+ *
+ * Thread which drives the libparam scheduler from a timerfd, see `pycsh.scheduler_tick()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Run the scheduler no later than `deadline_ns` (CLOCK_MONOTONIC), in addition to the regular ticks.
+ *
+ * Allows schedules spaced closer than the tick period to be served on time. Does not require the GIL.
+ *
+ * @return 0 on success, -1 when the tick is not running.
+ */
+int pycsh_scheduler_tick_wake(uint64_t deadline_ns);
+
+PyObject * pycsh_scheduler_tick(PyObject * self, PyObject * args, PyObject * kwds);
+PyObject * pycsh_scheduler_wake(PyObject * self, PyObject * args, PyObject * kwds);
+PyObject * pycsh_scheduler_tick_stats(PyObject * self, PyObject * args, PyObject * kwds);
@@ -0,0 +1,96 @@
+/*
+ * stats.h
+ *
+ * Always-on per-node transaction counters and latency histograms.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+	PYCSH_STATS_PULL,
+	PYCSH_STATS_PUSH,
+	PYCSH_STATS_PULL_ALL,
+	PYCSH_STATS_VMEM,
+	PYCSH_STATS_CALLBACK,
+	PYCSH_STATS_KIND_COUNT,
+} pycsh_stats_kind_e;
+
+/* `timeout` which is derived from the measured round-trip time of the destination, see `pycsh_stats_timeout()`.
+	Passed as `timeout=None` from Python. */
+#define PYCSH_TIMEOUT_AUTO INT_MIN
+
+/* Latency bucket `i` counts samples in [2^i, 2^(i+1)) microseconds, the last bucket is open-ended. */
+#define PYCSH_STATS_HIST_BUCKETS 26
+
+/**
+ * @brief Monotonic timestamp in microseconds, used as `start_us` for `pycsh_stats_record()`.
+ */
+uint64_t pycsh_stats_now_us(void);
+
+/**
+ * @brief Record a completed (or timed out) transaction.
+ *
+ * Safe to call from any thread, without holding the GIL.
+ *
+ * @param node Node the transaction was sent to.
+ * @param kind Type of transaction.
+ * @param start_us `pycsh_stats_now_us()` from before the transaction started.
+ * @param timed_out Whether the transaction failed to receive a reply.
+ * @param tx_bytes Bytes sent.
+ * @param rx_bytes Bytes received.
+ */
+void pycsh_stats_record(int node, pycsh_stats_kind_e kind, uint64_t start_us, bool timed_out, uint32_t tx_bytes, uint32_t rx_bytes);
+
+/**
+ * @brief Feed the round-trip time estimator of `node` with a request which was replied to.
+ *
+ * Only single request/reply transactions should be sampled,
+ * the latency of multi-packet replies says little about the round-trip.
+ */
+void pycsh_stats_rtt_sample(int node, uint64_t sample_us);
+
+/**
+ * @brief Timeout for a request to `node`, from the round-trip times of its earlier replies.
+ *
+ * Follows RFC 6298: SRTT + 4*RTTVAR, doubled for each retry.
+ * Safe to call from any thread, without holding the GIL.
+ *
+ * @param attempt 0 for the first attempt, 1 for the first retry, and so on.
+ * @param fallback_ms Timeout when nothing has been measured yet, and upper bound of the returned timeout.
+ * @return Timeout in milliseconds.
+ */
+int pycsh_stats_timeout(int node, int attempt, int fallback_ms);
+
+/**
+ * @brief Resolve `PYCSH_TIMEOUT_AUTO` to a timeout for `node`, other timeouts are returned as is.
+ */
+int pycsh_stats_resolve_timeout(int timeout, int node, int attempt, int fallback_ms);
+
+/**
+ * @brief Record that a failed transaction is being retried.
+ */
+void pycsh_stats_retry(int node, pycsh_stats_kind_e kind);
+
+/**
+ * @brief Account received bytes to the transaction in progress on the calling thread.
+ *
+ * Intended for `param_transaction()` callbacks, which run in the thread that started the transaction.
+ */
+void pycsh_stats_rx_bytes(uint32_t rx_bytes);
+
+/**
+ * @brief Reset the received byte accumulator of the calling thread, and return its previous value.
+ */
+uint32_t pycsh_stats_rx_bytes_take(void);
+
+PyObject * pycsh_stats(PyObject * self, PyObject * args, PyObject * kwds);
@@ -34,6 +34,20 @@ void state_release_GIL(PyThreadState ** state);
 #define CLEANUP_GIL __attribute__((cleanup(cleanup_GIL)))
 #define AUTO_DECREF __attribute__((cleanup(cleanup_pyobject)))
 
+/* Lock for module state which is otherwise protected by the GIL.
+	Free-threaded builds (PEP 703) get a `PyMutex`, other builds a no-op.
+	Not all state is covered yet, so the module is not declared free-threading safe, and free-threaded builds re-enable the GIL on import. */
+#ifdef Py_GIL_DISABLED
+	typedef PyMutex pycsh_mutex_t;
+	#define pycsh_mutex_lock(_mutex) PyMutex_Lock(_mutex)
+	#define pycsh_mutex_unlock(_mutex) PyMutex_Unlock(_mutex)
+#else
+	typedef struct { char unused; } pycsh_mutex_t;
+	#define pycsh_mutex_lock(_mutex) ((void)(_mutex))
+	#define pycsh_mutex_unlock(_mutex) ((void)(_mutex))
+#endif
+#define PYCSH_MUTEX_INIT {0}
+
 
 #if PY_MAJOR_VERSION == 3 && PY_MINOR_VERSION >= 13
 	/* TODO Kevin: Find a good portable way to set exceptions with FromCause across 3.12 and 3.13. */
@@ -114,6 +128,25 @@ const param_t * _pycsh_util_find_param_t_hostname(PyObject * param_identifier, P
 PyObject * pycsh_util_get_type(PyObject * self, PyObject * args);
 
 
+/* Glob pattern, measured once, rather than for every parameter matched against it. */
+typedef struct {
+	const char * pattern;
+	size_t len;
+	size_t prefix_len;  // Literal characters before the first wildcard.
+	bool has_wildcard;
+	bool match_all;
+} pycsh_glob_t;
+
+/**
+ * @brief Prepare `pattern` for `pycsh_glob_match()`, NULL matches everything.
+ *
+ * `pattern` is not copied, and must outlive `glob`.
+ */
+void pycsh_glob_compile(pycsh_glob_t * glob, const char * pattern);
+
+/* Match `name` like libparam's `strmatch()` would. */
+bool pycsh_glob_match(const pycsh_glob_t * glob, const char * name);
+
 /**
  * @brief Return a list of Parameter wrappers similar to the "list" slash command
  * 
@@ -122,6 +155,25 @@ PyObject * pycsh_util_get_type(PyObject * self, PyObject * args);
  */
 PyObject * pycsh_util_parameter_list(uint32_t mask, int node, const char * globstr);
 
+/* Element `i` of a numeric parameter as a double, 0 for other types. Does not require the GIL. */
+double pycsh_param_get_double(const param_t * param, unsigned int i);
+
+/**
+ * @brief Milliseconds since the value of a remote parameter was last received, according to `param->timestamp`.
+ *
+ * @return Age in milliseconds, or -1 when unknown (local parameter, no timestamp, or timestamp in the future).
+ */
+int64_t pycsh_param_age_ms(const param_t * param);
+
+/**
+ * @brief Whether the cached value of `param` is younger than `max_age_ms`, and may be used instead of pulling it.
+ *
+ * Always false when `max_age_ms` is 0, or when `host` (INT_MIN for `*param->node`) is not the node of `param`.
+ * Array parameters are only fresh when all of their elements were received within `max_age_ms`,
+ * as `param->timestamp` is also updated by single offsets.
+ */
+bool pycsh_param_is_fresh(const param_t * param, int host, unsigned int max_age_ms);
+
 /* Private interface for getting the value of single parameter
    Increases the reference count of the returned item before returning.
    Use INT_MIN for offset as no offset. */
@@ -155,6 +207,26 @@ ParameterObject * Parameter_wraps_param(const param_t *param);
    Supports Python backwards subscriptions, mutates the index to a positive value in such cases. */
 int _pycsh_util_index(int seqlen, int *index);
 
+/**
+ * @brief Pull an already built GET queue from `host`.
+ *
+ * Blocks for up to `timeout`, so the GIL should be released by the caller.
+ *
+ * @param params Parameters in `queue`, whose values are updated from the reply.
+ * @return 0 on success, otherwise negative.
+ */
+int pycsh_param_pull_queue_params(param_queue_t *queue, const param_t **params, size_t param_cnt, int verbose, int host, int timeout);
+
+/**
+ * @brief Push an already built SET queue to `host`.
+ *
+ * Blocks for up to `timeout`, so the GIL should be released by the caller.
+ *
+ * @param params Parameters in `queue`, whose values are updated from the ack when `ack_with_pull` is true.
+ * @return 0 on success, otherwise negative.
+ */
+int pycsh_param_push_queue_params(param_queue_t *queue, const param_t **params, size_t param_cnt, int verbose, int host, int timeout, bool ack_with_pull);
+
 int pycsh_param_pull_all(int prio, int verbose, int host, uint32_t include_mask, uint32_t exclude_mask, int timeout, int version, PyObject * py_err_callback);
 
 /**
@@ -166,5 +238,24 @@ int pycsh_param_pull_all(int prio, int verbose, int host, uint32_t include_mask,
  */
 int pycsh_parse_param_mask(PyObject * mask_in, uint32_t * mask_out);
 
+/**
+ * @brief "O&" converter for `timeout` arguments, where None selects `PYCSH_TIMEOUT_AUTO`.
+ *
+ * @param timeout_out int to store the timeout in.
+ * @return 1 on success, 0 with an exception set.
+ */
+int pycsh_parse_timeout(PyObject * timeout_in, void * timeout_out);
+
+/**
+ * @brief Cooperative cancellation point for long running operations, called with the GIL held between chunks of work.
+ *
+ * Runs pending signal handlers (i.e KeyboardInterrupt for Ctrl-C),
+ * and checks `cancel.is_set()` for any `threading.Event`-like `cancel` object.
+ *
+ * @param cancel Object with an `is_set()` method, or NULL/None.
+ * @return 0 to continue, -1 with an exception set when cancelled.
+ */
+int pycsh_check_cancel(PyObject * cancel);
+
 extern bool csp_router_is_running(void);
 extern void csp_router_set_running(bool is_running);
\ No newline at end of file
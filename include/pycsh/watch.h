@@ -0,0 +1,31 @@
+/*
+ * watch.h
+ *
+ * Push-based parameter watches, see `pycsh.watch()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+#include <param/param.h>
+
+/**
+ * @brief Notify watches that a new value has been applied to `param`.
+ *
+ * Cheap when nothing is being watched. Does not require the GIL, and never blocks on consumers.
+ * `param` must be the live `param_t` the value was applied to, watches are matched by its node and ID.
+ */
+void pycsh_watch_notify(const param_t * param);
+
+/* Whether any watches exist, allows callers to skip work only needed for `pycsh_watch_notify()` */
+bool pycsh_watch_enabled(void);
+
+extern PyTypeObject WatchType;
+
+PyObject * pycsh_watch(PyObject * self, PyObject * args, PyObject * kwds);
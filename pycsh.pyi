@@ -22,6 +22,7 @@ from typing import \
 from datetime import datetime as _datetime
 from typing_extensions import deprecated as _deprecated
 from io import IOBase as _IOBase, TextIOBase as _TextIOBase
+from threading import Event as _Event
 
 _param_value_hint = int | float | str
 _param_type_hint = _param_value_hint | bytearray
@@ -342,6 +343,14 @@ class ValueProxy:
     def __call__(self, host: int = None, timeout: int = None, retries: int = None, paramver: int = None, remote: bool = True, verbose: int = None) -> ValueProxy:
         """ Set attributes on `self` and return `self`, builder pattern like. """
 
+    @property
+    def age(self) -> int | None:
+        """
+        Age in milliseconds of the evaluated value, according to `Parameter.timestamp`.
+        None before evaluating, for local parameters, and when the parameter has no timestamp.
+        See also `pycsh.max_age()`.
+        """
+
     def __int__(self) -> (int|float|str) | _Iterable[int|float|str]:
         """ Evaluate the value before returning it. """
 
@@ -430,6 +439,7 @@ class Parameter:
         :param param_identifier: an int or string of the parameter ID or name respectively.
         :param Attempt lookup of known host if string is specified.: Node on which the parameter is located.
         :param timeout: Default timeout period for this parameter in milliseconds.
+            None derives it from the measured round-trip time of the node, doubling it for each retry.
         :param retries: Number of retries available for timeouts.
 
         :raises ValueError: When no parameter can be found from an otherwise valid identifier.
@@ -480,6 +490,25 @@ class Parameter:
         Change the callback of the parameter
         """
 
+    @property
+    def callback_filtered(self) -> int:
+        """
+        Number of values kept from the callback by the filter set with `set_callback_filter()`.
+        """
+
+    def set_callback_filter(self, on_change: bool = False, deadband: float = 0.0, rel_deadband: float = 0.0, min_interval: int = 0) -> None:
+        """
+        Only call the callback for values which are worth reacting to.
+        Values are compared to the last value the callback was called for, without taking the GIL.
+        Calling it without arguments removes the filter, as does deallocating this Parameter object.
+
+        :param on_change: Only call the callback when the value changed.
+        :param deadband: Only call the callback when a numeric value changed by more than this.
+        :param rel_deadband: Like `deadband`, as a fraction of the last value.
+        :param min_interval: Call the callback at most once per this many milliseconds.
+        :raises ValueError: When a deadband is negative.
+        """
+
     def __len__(self) -> int:
         """
         Gets the length of array parameters.
@@ -557,14 +586,14 @@ class Parameter:
         """ Returns the timestamp of the wrapped param_t C struct. """
 
     @property
-    def timeout(self) -> int:
-        """ Returns the default timeout of the Parameter value in milliseconds. """
+    def timeout(self) -> int | None:
+        """ Returns the default timeout of the Parameter value in milliseconds, None when it is adaptive. """
 
     @timeout.setter
-    def timeout(self, value: int) -> None:
+    def timeout(self, value: int | None) -> None:
         """
         Sets the default timeout of the Parameter in milliseconds.
-        Use None to reset default value.
+        Use None to derive it from the measured round-trip time of the node.
         """
 
     @property
@@ -636,7 +665,8 @@ class PythonGetSetParameter(Parameter):
 
     def __new__(cls, id: int, name: str, type: int, mask: int | str, unit: str = None, docstr: str = None, array_size: int = 0,
                    callback: _Callable[[Parameter, int], None] = None, host: int = None, timeout: int = None,
-                   retries: int = 0, paramver: int = 2, getter: _Callable[[Parameter, int], _Any] = None, setter: _Callable[[Parameter, int, _Any], None] = None) -> PythonGetSetParameter:
+                   retries: int = 0, paramver: int = 2, getter: _Callable[[Parameter, int], _Any] = None, setter: _Callable[[Parameter, int, _Any], None] = None,
+                   cache_period: int = None) -> PythonGetSetParameter:
         """
         Allows you to specify a `getter` and `setter` function for the parameter.
         Signature for the getter:
@@ -652,6 +682,32 @@ class PythonGetSetParameter(Parameter):
             " receives the parameter and index for which to set the value. Also receives the actual value to set.
                 The setter should not return anything. "
         ```
+
+        :param cache_period: Milliseconds to keep getter results for, 0 keeps them until `invalidate()`.
+            Cached values are served to remote pulls without calling the getter (or taking the GIL).
+            None (the default) calls the getter for every read.
+        """
+
+    @property
+    def cache_period(self) -> int | None:
+        """
+        Milliseconds to keep getter results for, 0 keeps them until `invalidate()`, None disables the cache.
+        Changing it invalidates the cached values.
+        """
+
+    @cache_period.setter
+    def cache_period(self, cache_period: int | None) -> None:
+        """
+        Change how long getter results are cached for.
+        """
+
+    def invalidate(self, offset: int = None) -> None:
+        """
+        Discard the cached getter result, so the getter is called for the next read.
+        Values set through the setter are invalidated automatically.
+
+        :param offset: Index to invalidate, all indexes when None.
+        :raises IndexError: When `offset` is out of range.
         """
 
 
@@ -690,6 +746,183 @@ class ParameterList(_pylist[Parameter], _Iterable):
         """
 
 
+class ParameterListView(_Iterable):
+    """
+    Lazy, read-only view of parameters in the global list, as returned by `pycsh.list(lazy=True)`.
+
+    Holds only references to the underlying parameters,
+    Parameter objects are created when elements are accessed.
+    """
+
+    def __len__(self) -> int: ...
+
+    @_overload
+    def __getitem__(self, index: int) -> Parameter: ...
+    @_overload
+    def __getitem__(self, index: slice) -> ParameterListView: ...
+
+    def __iter__(self) -> _Iterator[Parameter]: ...
+
+    @property
+    def names(self) -> tuple[str, ...]:
+        """ Names of the parameters in the view, without creating Parameter objects. """
+
+    def filter(self, node: int = -1, mask: str | int = None, globstr: str = None) -> ParameterListView:
+        """
+        Return a new view of the parameters matching all the provided arguments.
+
+        :param node: Only include parameters of this node, -1 for all nodes.
+        :param mask: Only include parameters with any of these mask bits.
+        :param globstr: Only include parameters with names matching this wildcard pattern.
+        """
+
+    def to_list(self) -> ParameterList:
+        """ Create Parameter objects for every parameter in the view, and return them as a ParameterList. """
+
+
+class Watch:
+    """
+    Values of watched parameters, as they are received from the network. Returned by `pycsh.watch()`.
+
+    Values are queued by pulls, pushes and the parameter sniffer, without waiting for the GIL.
+
+    >>> with pycsh.watch(["temp", "mode"]) as watch:
+    ...     for param, value, timestamp in watch.read(timeout=1000):
+    ...         print(param.name, value, timestamp)
+    """
+
+    def read(self, timeout: int = 0, max_count: int = -1) -> list[tuple[Parameter, _Any, float]]:
+        """
+        Return the received values, oldest first.
+
+        :param timeout: Milliseconds to wait for the first value, when none are pending. -1 waits indefinitely.
+        :param max_count: Return at most this many values, -1 for all of them.
+        :returns: list of (Parameter, value, receive timestamp)
+        """
+
+    def fileno(self) -> int:
+        """
+        :returns: a file descriptor which is readable while values are pending,
+            for use with `select()` or `asyncio.get_event_loop().add_reader()`.
+        """
+
+    def close(self) -> None:
+        """ Stop watching. Pending values are discarded. """
+
+    def __enter__(self) -> Watch: ...
+    def __exit__(self, *args) -> bool: ...
+
+    def __len__(self) -> int:
+        """ :returns: number of pending values """
+
+    @property
+    def dropped(self) -> int:
+        """ Number of values dropped because the consumer fell more than `maxlen` values behind. """
+
+    @property
+    def parameters(self) -> tuple[Parameter, ...]:
+        """ The watched parameters. """
+
+
+class GatherScope:
+    """
+    Pulls the values read through `Parameter.value` within it together. Returned by `pycsh.gather_scope()`.
+
+    `Parameter.value` returns a lazy ValueProxy, which is only pulled when used.
+    Inside the scope, using one pulls all the unused ones with it, with one request per node.
+
+    >>> with pycsh.gather_scope():
+    ...     total = a.value + b.value * c.value  # One request, rather than three
+    """
+
+    def __enter__(self) -> GatherScope: ...
+    def __exit__(self, *args) -> bool: ...
+
+
+class Batch:
+    """
+    Remote parameter writes, queued while the batch is entered. Returned by `pycsh.batch()`.
+
+    Writes are pushed when the batch exits, packed into as few packets as possible per destination.
+    Writes are discarded, rather than pushed, when the block raises an exception.
+
+    >>> with pycsh.batch(node=3) as batch:
+    ...     mode.value = 2
+    ...     gain.value = [1, 2, 3, 4]
+    >>> all(acked for _, _, acked in batch.results)
+    True
+    """
+
+    def flush(self) -> list[tuple[Parameter, int | None, bool]]:
+        """
+        Push the writes queued so far, and keep batching.
+
+        :returns: The new `results`
+        """
+
+    def discard(self) -> None:
+        """ Drop the writes queued so far, without pushing them. """
+
+    def __enter__(self) -> Batch: ...
+    def __exit__(self, *args) -> bool:
+        """ :raises ConnectionError: When any of the writes were not acknowledged, see `results`. """
+
+    def __len__(self) -> int:
+        """ :returns: number of queued writes """
+
+    @property
+    def results(self) -> list[tuple[Parameter, int | None, bool]]:
+        """
+        (Parameter, array offset, acknowledged) of each write pushed by the latest flush, in the order they were made.
+        A write is acknowledged when the packet it was sent in was.
+        """
+
+
+class ParameterHistory:
+    """
+    Recently received values of a parameter, returned by `pycsh.history()`.
+
+    Samples are recorded whenever a value is applied to the parameter,
+    whether by pulls, pushes or the parameter sniffer.
+    Values are stored as floats, so 64-bit integers beyond 2**53 lose precision.
+
+    >>> import numpy as np
+    >>> timestamps, values = pycsh.history("temp").window(seconds=300)
+    >>> np.polyfit(np.asarray(timestamps), np.asarray(values), 1)[0]  # Trend per second
+    """
+
+    def window(self, index: int = 0, seconds: float = -1, count: int = -1) -> tuple[memoryview, memoryview]:
+        """
+        Return the recorded samples of an element of the parameter, oldest first.
+
+        The returned memoryviews reference the ring buffer itself, and are not copied.
+        Every sample recorded while they are held overwrites the oldest remaining one,
+        so after N new samples, up to the N oldest samples in the views have changed.
+        Use `numpy.array()` rather than `numpy.asarray()` for a stable copy.
+
+        :param index: Array index of the parameter.
+        :param seconds: Only include samples from the last `seconds` seconds, negative for all.
+        :param count: Only include the newest `count` samples, negative for all.
+        :raises IndexError: When index is out of range.
+        :returns: (timestamps, values) as read-only memoryviews of doubles, timestamps in seconds since the epoch.
+        """
+
+    def __len__(self) -> int:
+        """ :returns: number of samples currently kept """
+
+    @property
+    def capacity(self) -> int:
+        """ Maximum number of samples kept. """
+
+    @property
+    def recorded(self) -> int:
+        """ Total number of samples recorded, including those no longer kept. """
+
+    @property
+    def parameter(self) -> Parameter:
+        """ The recorded parameter. """
+
+
 class SlashCommand:
     """ Wrapper class for slash commands """
 
@@ -957,6 +1190,37 @@ class Vmem:
         :return: Tuple of Vmem area object instances.
         """
 
+    @classmethod
+    def serve(cls, name: str, buffer: _Any, vaddr: int = None, readonly: bool = False) -> Vmem:
+        """
+        Serve a buffer object (bytearray, numpy array, mmap, etc.) as a vmem area of the local vmem server,
+        so remote nodes can download (and upload to) it with `vmem_download()`, without copying it into parameters.
+
+        The vmem server copies directly from/to the buffer, which must therefore be contiguous,
+        and stays exported (i.e a bytearray can't be resized) until `Vmem.unserve()`.
+        At most 8 areas can be served at a time.
+
+        :param name: Name of the vmem area, at most 16 characters (vmem list version 2 only shows the first 5).
+        :param buffer: Buffer protocol object to serve, must be writable unless `readonly`.
+        :param vaddr: Virtual address of the area, by default one of 8 slots of 1 TiB from 0x7000000000000000.
+        :param readonly: Serve a read-only buffer, and ignore uploads.
+
+        :raises BufferError: When `buffer` is not a contiguous (writable) buffer.
+        :raises ValueError: When `name` is already served, or the area overlaps another.
+        :raises MemoryError: When all slots are in use.
+
+        :return: Vmem object describing the served area.
+        """
+
+    @classmethod
+    def unserve(cls, name: str) -> None:
+        """
+        Stop serving a vmem area added by `Vmem.serve()`, and release its buffer.
+        Waits for transfers in progress to finish.
+
+        :raises KeyError: When `name` is not served.
+        """
+
 
 _param_ident_hint = int | str | Parameter  # Types accepted for finding a param_t
 
@@ -972,6 +1236,7 @@ def get(param_identifier: _param_ident_hint, node: int|str = None, server: int =
     :param paramver: parameter system version (default = 2)
     :param offset: Index to use for array parameters.
     :param timeout: Timeout of pull transaction in milliseconds (Has no effect when autosend is 0).
+        None derives it from the measured round-trip time of the node, doubling it for each retry.
     :param retries: Number of retries available for timeouts.
 
     :raises TypeError: When an invalid param_identifier type is provided.
@@ -992,6 +1257,7 @@ def set(param_identifier: _param_ident_hint, value: _param_value_hint | _Iterabl
     :param paramver: parameter system version (default = 2)
     :param offset: Index to use for array parameters.
     :param timeout: Timeout of push transaction in milliseconds (Has no effect when autosend is 0).
+        None derives it from the measured round-trip time of the node, doubling it for each retry.
     :param retries: Number of retries available for timeouts.
 
     :raises TypeError: When an invalid param_identifier type is provided.
@@ -1062,6 +1328,21 @@ def timeout(timeout: int = None, verbose: int = None) -> int:
     :return: The current/new default timeout.
     """
 
+def max_age(max_age: int = None, verbose: int = None) -> int:
+    """
+    Used to get or change the maximum age of cached remote values.
+
+    Reads of remote parameters (`pycsh.get()`, `Parameter.value`, etc.) will not pull the value,
+    when it was received less than `max_age` milliseconds ago, according to `Parameter.timestamp`.
+    Values are received from pulls, pushes with ack-with-pull, and the parameter sniffer.
+    Array parameters are only cached once all of their elements have been received together,
+    updates of single indexes don't make the other elements fresh.
+
+    :param max_age: Maximum age in milliseconds, 0 (the default) to always pull.
+    :param verbose: >=1 print when setting, >=2 also print when getting
+    :return: The current/new maximum age.
+    """
+
 def verbose(verbose: int = None) -> int:
     """
     Used to get or change the default parameter verbosity.
@@ -1073,14 +1354,15 @@ def verbose(verbose: int = None) -> int:
 def cmd() -> None:
     """ Print the current command. """
 
-def list(node: int = None, verbose: int = None, mask: str | int = None, globstr: str = None) -> ParameterList:
+def list(node: int = None, verbose: int = None, mask: str | int = None, globstr: str = None, lazy: bool = False) -> ParameterList | ParameterListView:
     """
     List all known parameters, remote and local alike.
 
     :param mask: Mask on which to filter the list.
+    :param lazy: Return a ParameterListView, which only creates Parameter objects for the elements accessed.
     """
 
-def list_download(node: int = None, timeout: int = None, version: int = 3, remote: bool = False) -> ParameterList:
+def list_download(node: int = None, timeout: int = None, version: int = 3, remote: bool = False, cache: str = None, cache_key: str = None, cache_max_age: int = 86400) -> ParameterList:
     """
     Download parameters from the specified node, adding them to the global parameter list.
 
@@ -1089,6 +1371,14 @@ def list_download(node: int = None, timeout: int = None, version: int = 3, remot
     :param version: Verbosity/version to use for the download. 3 includes docstring.
     :param remote: Whether to download remote parameters on the specified node as well.
         I.e, if downloading from another CSH, should we also download the remtote parameters it has downloaded?
+    :param cache: Directory in which to cache the downloaded list.
+        The node is identified before downloading, and the cached list is used when its software is unchanged.
+        Otherwise the list is downloaded, and the cache refreshed. Not used when `remote=True`.
+        The node's identity doesn't change when parameters are added without a software change (e.g. by APMs),
+        see `cache_key` and `cache_max_age`.
+    :param cache_key: Checksum or version of the parameter list, when the node provides one.
+        The cache is only used when it was saved with the same key.
+    :param cache_max_age: Seconds after which the cache is refreshed regardless, 0 for no limit.
 
     :raises RuntimeError: When called before .init().
     :raises ConnectionError: When no response is received.
@@ -1138,6 +1428,120 @@ def list_add(node: int, length: int, id: int, name: str, type: int, mask: int |
     :returns: Returns the created parameter.
     """
 
+def list_index_stats(reset: bool = False) -> dict[str, int]:
+    """
+    Return counters of the index used to find parameters by name or id,
+    i.e `pycsh.get("name")`, `pycsh.set("name", ...)` and `Parameter("name")`.
+
+    The index is rebuilt on the first lookup after the parameter list has been modified through PyCSH.
+    Misses fall back to searching the parameter list.
+
+    :param reset: Zero the "hits", "misses" and "rebuilds" counters.
+    :returns: dict with "entries", "hits", "misses" and "rebuilds".
+    """
+
+
+def watch(params: _Iterable[Parameter | str | int], maxlen: int = 1024, coalesce: bool = True) -> Watch:
+    """
+    Receive values of the specified parameters as they arrive from the network,
+    rather than polling them with `pycsh.pull()`.
+
+    :param params: Parameters to watch, or their names/IDs on the default node.
+    :param maxlen: Maximum number of pending values, the oldest are dropped beyond this.
+    :param coalesce: Keep only the newest pending value of each parameter.
+    :raises ValueError: When a parameter could not be found.
+    :returns: Watch, which should be closed when no longer needed.
+    """
+
+
+def callback_dispatch(deferred: bool = None, maxlen: int = None) -> bool:
+    """
+    Call Parameter callbacks from a dedicated thread, rather than the thread which received the value.
+
+    Values are typically received by the CSP router thread, which would otherwise wait for the GIL
+    and then run the callback, stalling all CSP traffic while doing so.
+    Only callbacks of values received without the GIL are deferred,
+    those of values set from Python still run before the assignment returns.
+    Callbacks receive the Parameter, so they read its current value, which may be newer than the one which triggered them.
+
+    :param deferred: Enable or disable deferred dispatch, None to leave it as is.
+        Disabling waits for the queued callbacks to be called, and therefore raises RuntimeError from within a deferred callback.
+        Callbacks still queued for a Parameter that is deleted are skipped.
+    :param maxlen: Maximum number of queued callbacks, further callbacks are dropped.
+    :returns: Whether deferred dispatch is enabled.
+    """
+
+def callback_dispatch_stats(reset: bool = False) -> dict[str, int | bool]:
+    """
+    :param reset: Zero the counters, except "depth".
+    :returns: dict with "deferred", "depth", "max_depth", "enqueued", "dispatched", "dropped",
+        "latency_us_total" and "latency_us_max", where latency is from queueing to calling the callback.
+    """
+
+
+def gather(*proxies: ValueProxy | Parameter) -> tuple[_Any, ...]:
+    """
+    Evaluate the provided values, pulling them with as few requests as possible per node,
+    rather than one request per value.
+    Values with different `paramver`, `timeout` or `retries` are pulled by separate requests.
+
+    >>> a, b, c = pycsh.gather(param_a.value, param_b.value, param_c)
+
+    :param proxies: ValueProxy objects, or Parameters to evaluate the `.value` of.
+    :raises ConnectionError: When a node did not respond.
+    :returns: tuple with the value of each of `proxies`.
+    """
+
+def gather_scope() -> GatherScope:
+    """
+    :returns: GatherScope, in which `Parameter.value` objects are pulled together when the first of them is used.
+    """
+
+
+def batch(node: int = None, ack_with_pull: bool = True, timeout: int = None, retries: int = 1, paramver: int = 2, verbose: int = -1) -> Batch:
+    """
+    Queue remote parameter writes made by the calling thread while the returned Batch is entered,
+    and push them together when it exits.
+
+    Reads and local parameters are not affected. Batches may be nested, writes go to the innermost one.
+
+    :param node: Push all writes to this node, rather than the node of each parameter.
+    :param ack_with_pull: Have the remote reply with the written values, which are then applied to the local parameters.
+    :param timeout: Timeout in milliseconds per packet, None to derive it from the round-trip time of the node.
+    :param retries: Number of attempts per packet.
+    :param paramver: Parameter system version of the packets.
+    :param verbose: Print the written parameters when > -1.
+    :returns: Batch, to be used as a context manager.
+    """
+
+
+def history_enable(capacity: int, node: int = -1, mask: str | int = None, globstr: str = None) -> None:
+    """
+    Keep the last `capacity` received values of parameters matching all the provided arguments.
+
+    When multiple calls match the same parameter, the last one wins.
+    A capacity of 0 thereby excludes parameters matched by earlier calls.
+    History is only kept for numeric parameters.
+
+    :param capacity: Number of samples to keep per parameter.
+    :param node: Only match parameters of this node, -1 for all nodes.
+    :param mask: Only match parameters with any of these mask bits.
+    :param globstr: Only match parameters with names matching this wildcard pattern.
+    """
+
+def history_disable() -> None:
+    """ Stop keeping history for all parameters. Existing ParameterHistory objects stop receiving values. """
+
+def history(param_identifier: Parameter | str | int, node: int = None) -> ParameterHistory | None:
+    """
+    Return the recently received values of a parameter.
+
+    :param param_identifier: Parameter, or its name or ID.
+    :param node: Node of the parameter, when not providing a Parameter. Defaults to the default node.
+    :raises ValueError: When the parameter could not be found.
+    :returns: ParameterHistory, or None when history is not enabled for the parameter, see `history_enable()`.
+    """
+
 
 def info() -> Info:
     """ Return local CSP interfaces and Routes, really just an alias for continuity with CSH. """
@@ -1198,6 +1602,61 @@ def get_type(param_identifier: _param_ident_hint, node: int = None) -> _param_ty
     :return: The best Python representation type object of the param_t c struct type. i.e int for uint32.
     """
 
+def crc32(data: bytes | bytearray | memoryview, value: int = 0) -> int:
+    """
+    CRC32C (Castagnoli) of `data`, as used by CSP for CRC32 packets and by `vmem_client_calc_crc32`.
+    Note that this is not the same CRC as `zlib.crc32()`.
+
+    Uses the SSE4.2 crc32 instruction when the CPU supports it, and releases the GIL for large buffers.
+
+    :param data: Bytes-like object to checksum.
+    :param value: Result of a previous call, to continue the CRC over multiple buffers.
+    :returns: CRC32C as an unsigned int.
+    """
+
+def stats(node: int = None, reset: bool = False) -> dict[int, dict[str, dict[str, _Any]]]:
+    """
+    Return transaction counters and latency histograms, collected since import (or the last reset).
+
+    Counters are kept per node and per kind of transaction ("pull", "push", "pull_all", "vmem" and "callback"),
+    each holding "requests", "timeouts", "retries", "tx_bytes", "rx_bytes", "latency_us_total" and "latency_hist".
+    Bucket `i` of "latency_hist" counts transactions which took [2^i, 2^(i+1)) microseconds.
+    Nodes beyond the first 256 distinct addresses are accumulated under node -1.
+
+    :param node: Only return counters for this node.
+    :param reset: Zero the returned counters.
+    :return: dict of {node: {kind: counters}}
+    """
+
+def scheduler_tick(rate: float = None) -> float:
+    """
+    Serve the libparam scheduler (queued "schedule push" commands) from a dedicated thread.
+
+    Ticks are driven by a timerfd at absolute deadlines, so they do not drift,
+    and ticks missed while the scheduler was busy are counted as overruns rather than made up for.
+
+    :param rate: Ticks per second, 0 stops the tick. None only returns the current rate.
+    :raises NotImplementedError: When libparam is built without the scheduler.
+    :raises ValueError: When rate is above 1 MHz.
+    :returns: The current rate, 0.0 when stopped.
+    """
+
+def scheduler_wake(delay: float) -> None:
+    """
+    Serve the libparam scheduler after `delay` seconds, in addition to the regular ticks.
+    Useful when a schedule is due sooner than the next tick.
+
+    :param delay: Seconds from now.
+    :raises RuntimeError: When the tick is not running.
+    """
+
+def scheduler_tick_stats(reset: bool = False) -> dict[str, int | float]:
+    """
+    :param reset: Zero the counters, except "jitter_us_last".
+    :returns: dict with "rate", "ticks", "wakeups", "overruns", "jitter_us_last", "jitter_us_max",
+        "jitter_us_total" and "update_us_max", where jitter is from the deadline to the thread waking up.
+    """
+
 
 # Vmem commands
 def vmem(node: int = None, timeout: int = None, version: int = None) -> str:
@@ -1216,7 +1675,7 @@ def vmem(node: int = None, timeout: int = None, version: int = None) -> str:
     :return: The string of the vmem areas at the specfied node.
     """
 
-def vmem_download(address: int, length: int, node: int = None, window: int = None, conn_timeout: int = None, packet_timeout: int = None, ack_timeout: int = None, timeout: int = None, version: int = 1, use_rdp: bool = True, verbose: int = None) -> bytes:
+def vmem_download(address: int, length: int, node: int = None, window: int = None, conn_timeout: int = None, packet_timeout: int = None, ack_timeout: int = None, timeout: int = None, version: int = 1, use_rdp: bool = True, verbose: int = None, chunk_size: int = 0, cancel: _Event = None) -> bytes:
     """
     Downloads a VMEM memory area specified by the argument, and return it as a `bytes` object.
 
@@ -1226,16 +1685,21 @@ def vmem_download(address: int, length: int, node: int = None, window: int = Non
     :param window: RDP Window.
     :param timeout: Timeout in ms when connecting to the node.
     :param verbose: Larger number prints more. Defaults to verbosity set by `pycsh.verbose()`.
+    :param chunk_size: Bytes downloaded per transfer, between which Ctrl-C and `cancel` are checked.
+        Every transfer is a new (RDP) connection, so small chunks cost a handshake each.
+        0 (default) downloads everything in one transfer, so `cancel` is only checked before it.
+    :param cancel: `threading.Event` (or any object with an `is_set()` method) which aborts the download when set.
 
     :raises RuntimeError: When called before .init().
     :raises ConnectionError: When the timeout is exceeded attempting to connect to the specified node.
     :raises MemoryError: When allocation of a CSP buffer fails.
+    :raises InterruptedError: When `cancel` is set.
     :raises Exception: For future/undocumented C errors (Must be caught after specific exception classes).
 
     :return: Bytes downloaded from the VMEM area. `len(.vmem_download(...))` may be short than `length` if the connection fails during download.
     """
 
-def vmem_upload(address: int, data_in: bytes | _IOBase, node: int = None, window: int = None, conn_timeout: int = None, packet_timeout: int = None, ack_timeout: int = None, ack_count: int = None, version: int = 1, verbose: int = None) -> int:
+def vmem_upload(address: int, data_in: bytes | _IOBase, node: int = None, window: int = None, conn_timeout: int = None, packet_timeout: int = None, ack_timeout: int = None, ack_count: int = None, version: int = 1, verbose: int = None, chunk_size: int = 0, cancel: _Event = None) -> int:
     """
     Uploads data from `data_in` to a VMEM memory area specified by the argument.
 
@@ -1244,16 +1708,53 @@ def vmem_upload(address: int, data_in: bytes | _IOBase, node: int = None, window
     :param node: Node from which the vmem should be listed.
     :param timeout: Timeout in ms when connecting to the node.
     :param verbose: Larger number prints more. Defaults to verbosity set by `pycsh.verbose()`.
+    :param chunk_size: Bytes uploaded per transfer, between which Ctrl-C and `cancel` are checked.
+        Every transfer is a new (RDP) connection, so small chunks cost a handshake each.
+        0 (default) uploads everything in one transfer, so `cancel` is only checked before it.
+    :param cancel: `threading.Event` (or any object with an `is_set()` method) which aborts the upload when set.
 
     :raises RuntimeError: When called before .init().
     :raises ConnectionError: When the timeout is exceeded attempting to connect to the specified node.
     :raises MemoryError: When allocation for a CSP buffer fails.
+    :raises InterruptedError: When `cancel` is set.
     :raises Exception: For future/undocumented C errors (Must be caught after specific exception classes).
 
     :returns: int of number of bytes uploaded. May be smaller than `data_in` if the transfer is interrupted.
     """
 
-def switch(slot: int, node: int = None, times: int = None, reboot_delay: int = 1000, verbose: int = None) -> None:
+def vmem_benchmark(address: int, length: int, node: int = None, window: int | _Iterable[int] = None, packet_timeout: int | _Iterable[int] = None, ack_timeout: int | _Iterable[int] = None, ack_count: int | _Iterable[int] = None, conn_timeout: int = None, repeat: int = 3, upload: bool = False, timeout: int = None, version: int = 1, verbose: int = None) -> dict[str, _Any]:
+    """
+    Sweep a grid of RDP options while repeatedly transferring a VMEM area, to find the best options for a given link.
+
+    Every combination of `window`, `packet_timeout`, `ack_timeout` and `ack_count` is tried `repeat` times.
+    Point `node` at our own address to benchmark the in-process vmem server over loopback/ZMQ.
+    RDP options are restored to the defaults when the sweep completes or fails,
+    which are also used for options that are not swept.
+
+    :param address: The VMEM address to transfer.
+    :param length: Number of bytes to transfer per attempt.
+    :param node: Node hosting the VMEM area.
+    :param window: RDP window(s) to try.
+    :param packet_timeout: RDP packet timeout(s) in ms to try.
+    :param ack_timeout: RDP ack timeout(s) in ms to try.
+    :param ack_count: RDP ack count(s) to try.
+    :param conn_timeout: RDP connection timeout in ms, used for all attempts. Defaults to the RDP default.
+    :param repeat: Number of transfers per combination.
+    :param upload: Benchmark uploads instead of downloads. The area is downloaded once and uploaded back unchanged.
+    :param timeout: Timeout in ms when connecting to the node.
+    :param verbose: Larger number prints more. Defaults to verbosity set by `pycsh.verbose()`.
+
+    :raises RuntimeError: When called before .init().
+    :raises ValueError: When the sweep grid or repeat count is invalid.
+    :raises ConnectionError: When `upload=True` and the initial download fails.
+
+    :return: dict with a "trials" list, and a "recommended" trial (or None when every combination failed at least once).
+        Each trial holds the RDP options, "succeeded"/"failed" counts, median "throughput" in bytes/s,
+        "latency_ms" percentiles (min/p50/p90/p99/max), interface "packets" and "drops" per transfer,
+        and estimated "retransmissions" per transfer relative to the least packet-hungry combination.
+    """
+
+def switch(slot: int, node: int = None, times: int = None, reboot_delay: int = 1000, verbose: int = None, cancel: _Event = None) -> None:
     """
     Reboot into the specified firmware slot.
 
@@ -1262,13 +1763,16 @@ def switch(slot: int, node: int = None, times: int = None, reboot_delay: int = 1
     :param times: number of times to boot into this slot (default = 1).
     :param reboot_delay: How long to wait before checking if module has finished rebooting.
     :param verbose: Larger numbers mean more `printf()`.
+    :param cancel: `threading.Event` which stops waiting for the reboot when set.
 
     :raises ConnectionError: When the system cannot be pinged after reboot.
+    :raises InterruptedError: When `cancel` is set.
     """
 
-def program(slot: int, filename: str, node: int = None, do_crc32: bool = False, *, window: int = None, conn_timeout: int = None, packet_timeout: int = None, delayed_acks: int = None, ack_timeout: int = None, ack_count: int = None) -> None:
+def program(slot: int, filename: str, node: int = None, do_crc32: bool = False, *, window: int = None, conn_timeout: int = None, packet_timeout: int = None, delayed_acks: int = None, ack_timeout: int = None, ack_count: int = None, chunk_size: int = 262144, cancel: _Event = None) -> None:
     """
     Upload new firmware to a module.
+    Other Python threads keep running during the upload, which may be aborted by Ctrl-C or `cancel`.
 
     :param slot: Flash slot to upload to, cannot be the currently booted one.
     :param filename: firmware .bin file to upload.
@@ -1283,16 +1787,20 @@ def program(slot: int, filename: str, node: int = None, do_crc32: bool = False,
     :param delayed_acks: ¯|_(ツ)_/¯ (keyword-only)
     :param ack_timeout: rdp max acknowledgement interval (default = 2 seconds) (keyword-only)
     :param ack_count: rdp ack for each (default = 2 packets) (keyword-only)
+    :param chunk_size: Bytes per vmem transfer, between which `cancel` is checked, see `vmem_upload()`. 0 for one transfer, which cannot be cancelled. (default = 256 KiB) (keyword-only)
+    :param cancel: `threading.Event` which aborts the upload when set. (keyword-only)
 
     :raises IOError: When an invalid filename is specified.
     :raises LookupError: When an otherwise valid filename is incompatible with the specified module.
     :raises ProgramDiffError: See class docstring.
     :raises ConnectionError: When no connection to the specified node can be established.
+    :raises InterruptedError: When `cancel` is set.
     """
 
-def sps(from_: int, to: int, filename: str, node: int = None, reboot_delay: int = 1000, verbose: int = None, *, window: int = None, conn_timeout: int = None, packet_timeout: int = None, delayed_acks: int = None, ack_timeout: int = None, ack_count: int = None) -> None:
+def sps(from_: int, to: int, filename: str, node: int = None, reboot_delay: int = 1000, verbose: int = None, *, window: int = None, conn_timeout: int = None, packet_timeout: int = None, delayed_acks: int = None, ack_timeout: int = None, ack_count: int = None, chunk_size: int = 262144, cancel: _Event = None) -> None:
     """
     Switch -> Program -> Switch
+    Other Python threads keep running meanwhile, and it may be aborted by Ctrl-C or `cancel`.
 
     :param from: Flash slot to program from.
     :param to: Flash slot to program.
@@ -1307,11 +1815,14 @@ def sps(from_: int, to: int, filename: str, node: int = None, reboot_delay: int
     :param delayed_acks: ¯|_(ツ)_/¯ (keyword-only)
     :param ack_timeout: rdp max acknowledgement interval (default = 2 seconds) (keyword-only)
     :param ack_count: rdp ack for each (default = 2 packets) (keyword-only)
+    :param chunk_size: Bytes per vmem transfer, between which `cancel` is checked, see `vmem_upload()`. 0 for one transfer, which cannot be cancelled. (default = 256 KiB) (keyword-only)
+    :param cancel: `threading.Event` which aborts the upload or reboot wait when set. (keyword-only)
 
     :raises IOError: When an invalid filename is specified.
     :raises LookupError: When an otherwise valid filename is incompatible with the specified module.
     :raises ProgramDiffError: See class docstring.
     :raises ConnectionError: When no connection to the specified node can be established.
+    :raises InterruptedError: When `cancel` is set.
     """
 
 def apm_load(path: str = '~/.local/lib/csh/', filename: str = None, stop_on_error: bool = False, verbose: int = ...) -> dict[str, _ModuleType | Exception]:
@@ -1354,15 +1865,42 @@ def vm_stop() -> None:
     Can be called multiple times without exception. 
     """
 
-def csp_init(host: str = None, model: str = None, revision: str = None, version: int = 2, dedup: int = 3) -> None:
+def csp_init(host: str = None, model: str = None, revision: str = None, version: int = 2, dedup: int = 3,
+             router_cpus: _Iterable[int] = None, router_priority: int = 0, vmem_cpus: _Iterable[int] = None, vmem_priority: int = 0,
+             stack_size: int = 0) -> None:
     """
     Initialize CSP
 
+    Scheduling options which the process is not permitted to apply (i.e SCHED_FIFO without CAP_SYS_NICE)
+    raise a RuntimeWarning, and the thread is started with default options instead.
+
     :param host: Hostname (default = linux hostname)
     :param model: Model name (default = linux get domain name)
     :param revision: Revision (default = release name)
     :param version: CSP version (default = 2)
     :param dedup: CSP dedup 0=off 1=forward 2=incoming 3=all (default)
+    :param router_cpus: CPUs to pin the router thread to (default = any)
+    :param router_priority: SCHED_FIFO priority of the router thread, 0 for the default policy
+    :param vmem_cpus: CPUs to pin the vmem server thread to (default = any)
+    :param vmem_priority: SCHED_FIFO priority of the vmem server thread, 0 for the default policy
+    :param stack_size: Stack size in bytes of the router and vmem server threads, 0 for the default
+
+    :raises ValueError: On invalid scheduling options.
+    """
+
+def router_stats(reset: bool = False) -> dict[str, int]:
+    """
+    Counters of the router thread started by `csp_init()`, to find out why packets are dropped on a loaded host.
+
+    :param reset: Zero the counters, except "buffers_free" and libcsp's own drop counters.
+    :raises RuntimeError: When called before .csp_init().
+    :returns: dict with:
+        "iterations" (of the routing loop) and "routed" (packets),
+        "busy_us_total" and "busy_us_max" spent routing packets,
+        "callbacks", "callback_us_total" and "callback_us_max" spent in Python Parameter callbacks (including waiting for the GIL),
+        "preempted" (involuntary context switches of the router thread),
+        "buffers_free" and "buffers_free_min" (-1 before the first packet),
+        and libcsp's 8-bit wrapping "buffer_out", "conn_overflow", "conn_out" and "no_route" counters.
     """
 
 def csp_add_zmq(addr: int, server: str, promisc: int = 0, mask: int = 8, default: int = 0, pub_port: int = 6000, sub_port: int = 7000, sec_key: str|_TextIOBase|None = None) -> Interface:
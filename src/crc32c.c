@@ -0,0 +1,280 @@
+/*
+ * crc32c.c
+ *
+ * CRC32C (Castagnoli), as used by CSP. Selected once at runtime:
+ * - SSE4.2 crc32 instructions, running 3 independent streams over large buffers to hide the latency of the instruction,
+ *   after which the streams are combined by shifting their CRCs with precomputed "append zeros" tables.
+ * - Slice-by-8 tables otherwise, rather than CSP's byte-at-a-time table.
+ * Based on Mark Adler's crc32c.c.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/crc32c.h>
+
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define PYCSH_CRC32C_HAVE_SSE42
+#endif
+
+/* Reflected Castagnoli polynomial */
+#define POLY 0x82f63b78
+
+/* Buffers at least this large are checksummed without the GIL by `pycsh.crc32()`. */
+#define PYCSH_CRC32_NOGIL_LEN (64*1024)
+
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+static uint32_t (*crc32c_impl)(uint32_t crc, const uint8_t * next, size_t len) = NULL;
+
+static uint32_t crc32c_table[8][256];
+
+static uint64_t load_u64(const uint8_t * p) {
+	uint64_t word;
+	memcpy(&word, p, sizeof(word));
+	return word;
+}
+
+static void crc32c_init_sw(void) {
+	for (uint32_t n = 0; n < 256; n++) {
+		uint32_t crc = n;
+		for (int k = 0; k < 8; k++) {
+			crc = (crc & 1) ? (crc >> 1) ^ POLY : crc >> 1;
+		}
+		crc32c_table[0][n] = crc;
+	}
+	for (uint32_t n = 0; n < 256; n++) {
+		uint32_t crc = crc32c_table[0][n];
+		for (int k = 1; k < 8; k++) {
+			crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
+			crc32c_table[k][n] = crc;
+		}
+	}
+}
+
+static uint32_t crc32c_sw(uint32_t crc, const uint8_t * next, size_t len) {
+
+	uint64_t crc0 = crc ^ 0xffffffff;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	while (len && ((uintptr_t)next & 7) != 0) {
+		crc0 = crc32c_table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+		len--;
+	}
+
+	while (len >= 8) {
+		crc0 ^= load_u64(next);
+		crc0 = crc32c_table[7][crc0 & 0xff] ^
+			   crc32c_table[6][(crc0 >> 8) & 0xff] ^
+			   crc32c_table[5][(crc0 >> 16) & 0xff] ^
+			   crc32c_table[4][(crc0 >> 24) & 0xff] ^
+			   crc32c_table[3][(crc0 >> 32) & 0xff] ^
+			   crc32c_table[2][(crc0 >> 40) & 0xff] ^
+			   crc32c_table[1][(crc0 >> 48) & 0xff] ^
+			   crc32c_table[0][crc0 >> 56];
+		next += 8;
+		len -= 8;
+	}
+#endif
+
+	while (len) {
+		crc0 = crc32c_table[0][(crc0 ^ *next++) & 0xff] ^ (crc0 >> 8);
+		len--;
+	}
+
+	return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+#ifdef PYCSH_CRC32C_HAVE_SSE42
+
+/* Block sizes of the 3 parallel streams, with tables to shift a CRC over that many zeros. */
+#define LONG_BLOCK 8192
+#define SHORT_BLOCK 256
+
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+
+static uint32_t gf2_matrix_times(const uint32_t * mat, uint32_t vec) {
+	uint32_t sum = 0;
+	while (vec) {
+		if (vec & 1) {
+			sum ^= *mat;
+		}
+		vec >>= 1;
+		mat++;
+	}
+	return sum;
+}
+
+static void gf2_matrix_square(uint32_t * square, const uint32_t * mat) {
+	for (int n = 0; n < 32; n++) {
+		square[n] = gf2_matrix_times(mat, mat[n]);
+	}
+}
+
+/* Operator which appends `len` (a power of 2) zero bytes to a CRC. */
+static void crc32c_zeros_op(uint32_t * even, size_t len) {
+
+	uint32_t odd[32];  // Odd power of 2 zeros operator
+
+	/* One zero bit */
+	odd[0] = POLY;
+	uint32_t row = 1;
+	for (int n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+
+	gf2_matrix_square(even, odd);  // Two zero bits
+	gf2_matrix_square(odd, even);  // Four zero bits
+
+	/* The first square gives one zero byte in `even`, the next two zero bytes in `odd`, and so on. */
+	do {
+		gf2_matrix_square(even, odd);
+		len >>= 1;
+		if (len == 0) {
+			return;
+		}
+		gf2_matrix_square(odd, even);
+		len >>= 1;
+	} while (len);
+
+	memcpy(even, odd, sizeof(odd));
+}
+
+static void crc32c_zeros(uint32_t zeros[4][256], size_t len) {
+	uint32_t op[32];
+	crc32c_zeros_op(op, len);
+	for (uint32_t n = 0; n < 256; n++) {
+		zeros[0][n] = gf2_matrix_times(op, n);
+		zeros[1][n] = gf2_matrix_times(op, n << 8);
+		zeros[2][n] = gf2_matrix_times(op, n << 16);
+		zeros[3][n] = gf2_matrix_times(op, n << 24);
+	}
+}
+
+static inline uint32_t crc32c_shift(uint32_t zeros[4][256], uint32_t crc) {
+	return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw(uint32_t crc, const uint8_t * next, size_t len) {
+
+	uint64_t crc0 = crc ^ 0xffffffff;
+
+	while (len && ((uintptr_t)next & 7) != 0) {
+		crc0 = _mm_crc32_u8(crc0, *next++);
+		len--;
+	}
+
+	/* The crc32 instruction has a latency of 3 cycles, but a throughput of 1 per cycle,
+		so 3 interleaved streams run about 3 times faster than one. */
+	while (len >= LONG_BLOCK*3) {
+		uint64_t crc1 = 0;
+		uint64_t crc2 = 0;
+		const uint8_t * const end = next + LONG_BLOCK;
+		do {
+			crc0 = _mm_crc32_u64(crc0, load_u64(next));
+			crc1 = _mm_crc32_u64(crc1, load_u64(next + LONG_BLOCK));
+			crc2 = _mm_crc32_u64(crc2, load_u64(next + LONG_BLOCK*2));
+			next += 8;
+		} while (next < end);
+		crc0 = crc32c_shift(crc32c_long, crc0) ^ crc1;
+		crc0 = crc32c_shift(crc32c_long, crc0) ^ crc2;
+		next += LONG_BLOCK*2;
+		len -= LONG_BLOCK*3;
+	}
+
+	while (len >= SHORT_BLOCK*3) {
+		uint64_t crc1 = 0;
+		uint64_t crc2 = 0;
+		const uint8_t * const end = next + SHORT_BLOCK;
+		do {
+			crc0 = _mm_crc32_u64(crc0, load_u64(next));
+			crc1 = _mm_crc32_u64(crc1, load_u64(next + SHORT_BLOCK));
+			crc2 = _mm_crc32_u64(crc2, load_u64(next + SHORT_BLOCK*2));
+			next += 8;
+		} while (next < end);
+		crc0 = crc32c_shift(crc32c_short, crc0) ^ crc1;
+		crc0 = crc32c_shift(crc32c_short, crc0) ^ crc2;
+		next += SHORT_BLOCK*2;
+		len -= SHORT_BLOCK*3;
+	}
+
+	while (len >= 8) {
+		crc0 = _mm_crc32_u64(crc0, load_u64(next));
+		next += 8;
+		len -= 8;
+	}
+
+	while (len) {
+		crc0 = _mm_crc32_u8(crc0, *next++);
+		len--;
+	}
+
+	return (uint32_t)crc0 ^ 0xffffffff;
+}
+
+#endif  // PYCSH_CRC32C_HAVE_SSE42
+
+static void crc32c_init(void) {
+#ifdef PYCSH_CRC32C_HAVE_SSE42
+	if (__builtin_cpu_supports("sse4.2")) {
+		crc32c_zeros(crc32c_long, LONG_BLOCK);
+		crc32c_zeros(crc32c_short, SHORT_BLOCK);
+		crc32c_impl = crc32c_hw;
+		return;
+	}
+#endif
+	crc32c_init_sw();
+	crc32c_impl = crc32c_sw;
+}
+
+uint32_t pycsh_crc32c(uint32_t crc, const void * data, size_t len) {
+	pthread_once(&crc32c_once, crc32c_init);
+	return crc32c_impl(crc, data, len);
+}
+
+int pycsh_crc32c_verify(csp_packet_t * packet) {
+
+	if (packet->length < sizeof(uint32_t)) {
+		return CSP_ERR_CRC32;
+	}
+
+	const uint32_t crc = pycsh_crc32c(0, packet->data, packet->length - sizeof(uint32_t));
+	const uint8_t * const trailer = &packet->data[packet->length - sizeof(uint32_t)];
+	const uint32_t received = ((uint32_t)trailer[0] << 24) | ((uint32_t)trailer[1] << 16) | ((uint32_t)trailer[2] << 8) | trailer[3];
+	if (crc != received) {
+		return CSP_ERR_CRC32;
+	}
+
+	packet->length -= sizeof(uint32_t);
+	return CSP_ERR_NONE;
+}
+
+PyObject * pycsh_crc32(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	Py_buffer data;
+	unsigned int value = 0;
+
+	static char *kwlist[] = {"data", "value", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|I:crc32", kwlist, &data, &value))
+		return NULL;  // TypeError is thrown
+
+	uint32_t crc;
+	if (data.len >= PYCSH_CRC32_NOGIL_LEN) {
+		Py_BEGIN_ALLOW_THREADS;
+		crc = pycsh_crc32c(value, data.buf, data.len);
+		Py_END_ALLOW_THREADS;
+	} else {
+		crc = pycsh_crc32c(value, data.buf, data.len);
+	}
+	PyBuffer_Release(&data);
+
+	return PyLong_FromUnsignedLong(crc);
+}
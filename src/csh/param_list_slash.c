@@ -21,6 +21,7 @@
 #include <param/param_string.h>
 #ifdef HAVE_PYTHON
 #include <pycsh/param_list_py.h>
+#include <pycsh/param_index.h>
 #endif
 
 #include <endian.h>
@@ -104,6 +105,10 @@ Parameters can be manually added with 'list add'.");
     }
 
     param_list_download(node, timeout, version, include_remotes);
+#ifdef HAVE_PYTHON
+    /* Also when not run through `pycsh.slash_execute()`, e.g. by CSH loading us as an APM. */
+    pycsh_param_index_invalidate();
+#endif
 
     optparse_del(parser);
     return SLASH_SUCCESS;
@@ -232,6 +237,9 @@ static int list_add(struct slash *slash)
 
     if (param_list_add(param) != 0)
         param_list_destroy(param);
+#ifdef HAVE_PYTHON
+    pycsh_param_index_invalidate();
+#endif
 
     optparse_del(parser);
     return SLASH_SUCCESS;
@@ -14,13 +14,17 @@
 #include <mpack/mpack.h>
 #include <csp/csp.h>
 #include <csp/csp_hooks.h>
-#include <csp/csp_crc32.h>
+#include <csp/csp_iflist.h>
 
 #include "param_sniffer.h"
 #include "hk_param_sniffer.h"
 #include "victoria_metrics.h"
 #include "vts.h"
 
+#include <pycsh/watch.h>
+#include <pycsh/crc32c.h>
+#include <pycsh/history.h>
+
 extern int prometheus_started;
 extern int vm_running;
 
@@ -128,7 +132,7 @@ int param_sniffer_crc(csp_packet_t * packet) {
             return -1;
         }
         /* Verify CRC32 (does not include header for backwards compatability with csp1.x) */
-        if (csp_crc32_verify(packet) != 0) {
+        if (pycsh_crc32c_verify(packet) != CSP_ERR_NONE) {
             /* Checksum failed */
             printf("CRC32 verification error in param sniffer! Discarding packet\n");
             return -1;
@@ -178,6 +182,10 @@ static void * param_sniffer(void * arg) {
         csp_clock_get_time(&time_now);
         queue.last_timestamp = time_now;
 
+        /* The promiscuous queue also receives replies to our own pulls, which have already been applied (with callbacks),
+            so only apply those addressed to other nodes. They are still logged. */
+        const bool apply = csp_iflist_get_by_addr(packet->id.dst) == NULL;
+
         mpack_reader_t reader;
         mpack_reader_init_data(&reader, queue.buffer, queue.used);
         while(reader.data < reader.end) {
@@ -194,6 +202,17 @@ static void * param_sniffer(void * arg) {
             }
             const param_t * param = param_list_find_id(node, id);
             if (param) {
+                if (apply && *param->node != 0) {
+                    /* Keep our copy of the remote parameter current, which makes it available to `pycsh.max_age()` reads.
+                        Applied through a separate reader, as `param_sniffer_log()` consumes the value from `reader`. */
+                    mpack_reader_t apply_reader;
+                    mpack_reader_init_data(&apply_reader, reader.data, reader.end - reader.data);
+                    param_deserialize_from_mpack_to_param(NULL, NULL, (param_t *)param, offset, &apply_reader);
+                    mpack_reader_destroy(&apply_reader);
+                    *param->timestamp = (timestamp.tv_sec != 0) ? timestamp : time_now;
+                    pycsh_watch_notify(param);
+                    pycsh_history_record(param);
+                }
                 param_sniffer_log(NULL, &queue, param, offset, &reader, &timestamp);
             } else {
                 printf("Found unknown param node %d id %d\n", node, id);
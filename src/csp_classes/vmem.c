@@ -7,9 +7,69 @@
 
 #include "structmember.h"
 
+#include <pthread.h>
+
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
 
+/* Regions served by `Vmem.serve()`.
+	The vmem server only knows the areas in the "vmem" linker section, so the slots are reserved there,
+	and are listed (with size 0) by remote `vmem` commands until they are used. */
+typedef struct {
+	Py_buffer view;  // .buf is NULL while unused
+	bool readonly;
+	char name[16+1];
+	pthread_mutex_t lock;  // Held while the vmem server copies to/from `view`, never while waiting for the GIL.
+} served_region_t;
+
+static void served_read(const vmem_t * vmem, uint64_t addr, void * dataout, uint32_t len);
+static void served_write(const vmem_t * vmem, uint64_t addr, const void * datain, uint32_t len);
+
+#define SERVED_SLOT_INIT(_i) { \
+	.type = VMEM_TYPE_RAM, \
+	.read = served_read, \
+	.write = served_write, \
+	.name = served_regions[_i].name, \
+	.driver = &served_regions[_i], \
+}
+
+static served_region_t served_regions[PYCSH_VMEM_SERVE_SLOTS] = {
+	[0 ... PYCSH_VMEM_SERVE_SLOTS-1] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+};
+static vmem_t served_vmem[PYCSH_VMEM_SERVE_SLOTS] __attribute__((section("vmem"))) __attribute__((aligned(8))) __attribute__((used)) = {
+	SERVED_SLOT_INIT(0), SERVED_SLOT_INIT(1), SERVED_SLOT_INIT(2), SERVED_SLOT_INIT(3),
+	SERVED_SLOT_INIT(4), SERVED_SLOT_INIT(5), SERVED_SLOT_INIT(6), SERVED_SLOT_INIT(7),
+};
+static_assert(PYCSH_VMEM_SERVE_SLOTS == 8, "Update the SERVED_SLOT_INIT() list of served_vmem[]");
+
+/* Protects claiming and releasing slots. */
+static pycsh_mutex_t served_lock = PYCSH_MUTEX_INIT;
+
+static void served_read(const vmem_t * vmem, uint64_t addr, void * dataout, uint32_t len) {
+	served_region_t * const region = vmem->driver;
+
+	pthread_mutex_lock(&region->lock);
+	uint32_t copied = 0;
+	if (region->view.buf != NULL && addr < (uint64_t)region->view.len) {
+		copied = (len < region->view.len - addr) ? len : region->view.len - addr;
+		memcpy(dataout, (char*)region->view.buf + addr, copied);
+	}
+	pthread_mutex_unlock(&region->lock);
+
+	memset((char*)dataout + copied, 0, len - copied);
+}
+
+static void served_write(const vmem_t * vmem, uint64_t addr, const void * datain, uint32_t len) {
+	served_region_t * const region = vmem->driver;
+
+	pthread_mutex_lock(&region->lock);
+	if (region->view.buf != NULL && !region->readonly && addr < (uint64_t)region->view.len) {
+		const uint32_t copied = (len < region->view.len - addr) ? len : region->view.len - addr;
+		memcpy((char*)region->view.buf + addr, datain, copied);
+	}
+	pthread_mutex_unlock(&region->lock);
+}
+
 
 
 csp_packet_t * pycsh_vmem_client_list_get(int node, int timeout, int version) {
@@ -208,6 +268,175 @@ PyObject * Vmem_new(PyTypeObject *type, PyObject *args, PyObject *kwds) {
     return Py_NewRef(vmem_tuple);
 }
 
+static VmemObject * Vmem_from_vmem_t(PyTypeObject *type, const vmem_t * vmem) {
+
+	VmemObject *self = (VmemObject *)type->tp_alloc(type, 0);
+	if (self == NULL) {
+		return NULL;
+	}
+
+	self->vmem = (vmem_list3_t){
+		.vmem_id = vmem_ptr_to_index((vmem_t*)vmem),
+		.vaddr = vmem->vaddr,
+		.size = vmem->size,
+		.type = vmem->type,
+	};
+	strncpy(self->vmem.name, vmem->name, sizeof(self->vmem.name)-1);
+	return self;
+}
+
+/* Whether [vaddr, vaddr+size) overlaps any area in the "vmem" linker section. */
+static bool vmem_overlaps(uint64_t vaddr, uint64_t size) {
+	for (vmem_t * vmem = &__start_vmem; vmem < &__stop_vmem; vmem++) {
+		if (vmem->size > 0 && vaddr < vmem->vaddr + vmem->size && vmem->vaddr < vaddr + size) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static PyObject * Vmem_serve(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+
+	const char * name;
+	PyObject * buffer;
+	PyObject * vaddr_obj = Py_None;
+	int readonly = false;
+
+	static char *kwlist[] = {"name", "buffer", "vaddr", "readonly", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "sO|Op:serve", kwlist, &name, &buffer, &vaddr_obj, &readonly))
+		return NULL;  // TypeError is thrown
+
+	if (strlen(name) == 0 || strlen(name) > 16) {
+		PyErr_SetString(PyExc_ValueError, "Vmem name must be 1 to 16 characters");
+		return NULL;
+	}
+
+	Py_buffer view;
+	/* Requiring a contiguous buffer lets the vmem server copy straight from/to it.
+		Exporting it also prevents i.e a bytearray from being resized while served. */
+	if (PyObject_GetBuffer(buffer, &view, readonly ? PyBUF_SIMPLE : PyBUF_WRITABLE) < 0) {
+		return NULL;  // BufferError is thrown
+	}
+	if (view.len == 0) {
+		PyBuffer_Release(&view);
+		PyErr_SetString(PyExc_ValueError, "Cannot serve an empty buffer");
+		return NULL;
+	}
+
+	pycsh_mutex_lock(&served_lock);
+
+	int slot = -1;
+	for (int i = 0; i < PYCSH_VMEM_SERVE_SLOTS; i++) {
+		if (served_regions[i].view.buf == NULL) {
+			if (slot < 0) {
+				slot = i;
+			}
+		} else if (strcmp(served_regions[i].name, name) == 0) {
+			pycsh_mutex_unlock(&served_lock);
+			PyBuffer_Release(&view);
+			PyErr_Format(PyExc_ValueError, "Vmem '%s' is already served, see Vmem.unserve()", name);
+			return NULL;
+		}
+	}
+	if (slot < 0) {
+		pycsh_mutex_unlock(&served_lock);
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_MemoryError, "All %d served vmem slots are in use", PYCSH_VMEM_SERVE_SLOTS);
+		return NULL;
+	}
+
+	uint64_t vaddr = PYCSH_VMEM_SERVE_VADDR + (uint64_t)slot * PYCSH_VMEM_SERVE_STRIDE;
+	if (vaddr_obj != Py_None) {
+		vaddr = PyLong_AsUnsignedLongLong(vaddr_obj);
+		if (PyErr_Occurred()) {
+			pycsh_mutex_unlock(&served_lock);
+			PyBuffer_Release(&view);
+			return NULL;
+		}
+	} else if ((uint64_t)view.len > PYCSH_VMEM_SERVE_STRIDE) {
+		pycsh_mutex_unlock(&served_lock);
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "Buffers larger than %llu bytes must specify a vaddr", (unsigned long long)PYCSH_VMEM_SERVE_STRIDE);
+		return NULL;
+	}
+	if (vaddr + view.len < vaddr || vmem_overlaps(vaddr, view.len)) {
+		pycsh_mutex_unlock(&served_lock);
+		PyBuffer_Release(&view);
+		PyErr_Format(PyExc_ValueError, "Vmem '%s' at 0x%llx overlaps an existing vmem area", name, (unsigned long long)vaddr);
+		return NULL;
+	}
+
+	served_region_t * const region = &served_regions[slot];
+	vmem_t * const vmem = &served_vmem[slot];
+
+	pthread_mutex_lock(&region->lock);
+	region->view = view;
+	region->readonly = readonly || view.readonly;
+	strncpy(region->name, name, sizeof(region->name)-1);
+	vmem->vaddr = vaddr;
+	pthread_mutex_unlock(&region->lock);
+	/* The vmem server looks areas up without our lock, so a non-zero size publishes the slot. */
+	__atomic_store_n(&vmem->size, (uint64_t)view.len, __ATOMIC_RELEASE);
+
+	pycsh_mutex_unlock(&served_lock);
+
+	return (PyObject*)Vmem_from_vmem_t(type, vmem);
+}
+
+static PyObject * Vmem_unserve(PyTypeObject *type, PyObject *args, PyObject *kwds) {
+	(void)type;
+
+	const char * name;
+
+	static char *kwlist[] = {"name", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "s:unserve", kwlist, &name))
+		return NULL;  // TypeError is thrown
+
+	pycsh_mutex_lock(&served_lock);
+
+	for (int i = 0; i < PYCSH_VMEM_SERVE_SLOTS; i++) {
+		served_region_t * const region = &served_regions[i];
+		if (region->view.buf == NULL || strcmp(region->name, name) != 0) {
+			continue;
+		}
+
+		__atomic_store_n(&served_vmem[i].size, 0, __ATOMIC_RELEASE);
+
+		/* Claim the slot before releasing the GIL, so concurrent `unserve()`s don't find it by name.
+			`view.buf` stays set until we are done, so `serve()` doesn't reuse the slot either. */
+		Py_buffer view = region->view;
+		region->name[0] = '\0';
+		pycsh_mutex_unlock(&served_lock);
+
+		/* Wait for transfers in progress, which may otherwise copy from/to a released buffer. */
+		Py_BEGIN_ALLOW_THREADS;
+		pthread_mutex_lock(&region->lock);
+		region->view.buf = NULL;
+		region->view.obj = NULL;
+		pthread_mutex_unlock(&region->lock);
+		Py_END_ALLOW_THREADS;
+
+		PyBuffer_Release(&view);
+		Py_RETURN_NONE;
+	}
+
+	pycsh_mutex_unlock(&served_lock);
+	PyErr_Format(PyExc_KeyError, "Vmem '%s' is not served", name);
+	return NULL;
+}
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef Vmem_methods[] = {
+	{"serve", (PyCFunction)Vmem_serve, METH_VARARGS | METH_KEYWORDS | METH_CLASS, "Serve a buffer object as a vmem area of the local vmem server."},
+	{"unserve", (PyCFunction)Vmem_unserve, METH_VARARGS | METH_KEYWORDS | METH_CLASS, "Stop serving a vmem area added by Vmem.serve()."},
+	{NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
 static PyMemberDef Vmem_members[] = {
 	{"vaddr", T_LONG, offsetof(VmemObject, vmem.vaddr), READONLY, "Starting address of the VMEM area. Used for upload and download I think"},
     {"size", T_LONG, offsetof(VmemObject, vmem.size), READONLY, "Size of the VMEM area in bytes"},
@@ -226,5 +455,6 @@ PyTypeObject VmemType = {
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = Vmem_new,
 	.tp_members = Vmem_members,
+	.tp_methods = Vmem_methods,
 	.tp_str = (reprfunc)Vmem_str,
 };
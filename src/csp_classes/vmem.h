@@ -6,6 +6,12 @@
 #include <vmem/vmem_server.h>
 
 
+/* Number of vmem areas which may be served with `Vmem.serve()` at a time. */
+#define PYCSH_VMEM_SERVE_SLOTS 8
+/* Default virtual address of the first served area, each slot is given PYCSH_VMEM_SERVE_STRIDE bytes of address space. */
+#define PYCSH_VMEM_SERVE_VADDR 0x7000000000000000ULL
+#define PYCSH_VMEM_SERVE_STRIDE (1ULL << 40)
+
 csp_packet_t * pycsh_vmem_client_list_get(int node, int timeout, int version);
 
 typedef struct {
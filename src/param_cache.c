@@ -0,0 +1,253 @@
+/*
+ * param_cache.c
+ *
+ * Binary on-disk cache of downloaded parameter lists.
+ * Replaces downloading the list of a node, whose software has not changed since the cache was saved,
+ * with an mmap() and a pass over the records.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/param_cache.h>
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <csp/csp.h>
+#include <csp/csp_cmp.h>
+#include <param/param.h>
+#include <param/param_list.h>
+
+#include <pycsh/crc32c.h>
+
+#define PARAM_CACHE_MAGIC "PYCSHPL"
+#define PARAM_CACHE_VERSION 1
+
+/* The cache is only read by the host which wrote it, so fields are in native byte order. */
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	int32_t node;
+	uint32_t count;
+	uint32_t body_len;
+	uint32_t body_crc;
+	char fingerprint[PARAM_CACHE_FINGERPRINT_LEN];
+} param_cache_header_t;
+
+/* Followed by `name_len` + `unit_len` + `help_len` bytes of NUL terminated strings. */
+typedef struct {
+	uint16_t id;
+	uint16_t node;
+	int32_t type;
+	uint32_t mask;
+	int32_t array_size;
+	int32_t storage_type;
+	uint16_t name_len;
+	uint16_t unit_len;
+	uint16_t help_len;
+	uint16_t reserved;
+} param_cache_record_t;
+
+int pycsh_param_cache_fingerprint(int node, int timeout, char * out, size_t out_len) {
+
+	struct csp_cmp_message msg = {0};
+	if (csp_cmp_ident(node, timeout, &msg) != CSP_ERR_NONE) {
+		return -1;
+	}
+
+	snprintf(out, out_len, "%.*s %.*s %.*s %.*s",
+		(int)sizeof(msg.ident.hostname), msg.ident.hostname,
+		(int)sizeof(msg.ident.revision), msg.ident.revision,
+		(int)sizeof(msg.ident.date), msg.ident.date,
+		(int)sizeof(msg.ident.time), msg.ident.time);
+	return 0;
+}
+
+static size_t field_len(const char * str) {
+	return str ? strlen(str) + 1 : 0;
+}
+
+int pycsh_param_cache_save(const char * path, int node, const char * fingerprint) {
+
+	/* First pass to size the body, so it can be written with a single fwrite(). */
+	size_t body_len = 0;
+	uint32_t count = 0;
+	const param_t * param;
+	param_list_iterator i = {0};
+	while ((param = param_list_iterate(&i)) != NULL) {
+		if (*param->node != node) {
+			continue;
+		}
+		body_len += sizeof(param_cache_record_t) + field_len(param->name) + field_len(param->unit) + field_len(param->docstr);
+		count++;
+	}
+
+	uint8_t * const body = malloc(body_len > 0 ? body_len : 1);
+	if (body == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	size_t offset = 0;
+	i = (param_list_iterator){0};
+	while ((param = param_list_iterate(&i)) != NULL && offset < body_len) {
+		if (*param->node != node) {
+			continue;
+		}
+		const param_cache_record_t record = {
+			.id = param->id,
+			.node = *param->node,
+			.type = param->type,
+			.mask = param->mask,
+			.array_size = param->array_size,
+			.storage_type = param->vmem ? (int32_t)param->vmem->type : -1,
+			.name_len = field_len(param->name),
+			.unit_len = field_len(param->unit),
+			.help_len = field_len(param->docstr),
+		};
+		memcpy(&body[offset], &record, sizeof(record));
+		offset += sizeof(record);
+		memcpy(&body[offset], param->name, record.name_len);
+		offset += record.name_len;
+		if (record.unit_len) {
+			memcpy(&body[offset], param->unit, record.unit_len);
+			offset += record.unit_len;
+		}
+		if (record.help_len) {
+			memcpy(&body[offset], param->docstr, record.help_len);
+			offset += record.help_len;
+		}
+	}
+
+	param_cache_header_t header = {
+		.magic = PARAM_CACHE_MAGIC,
+		.version = PARAM_CACHE_VERSION,
+		.node = node,
+		.count = count,
+		.body_len = offset,
+		.body_crc = pycsh_crc32c(0, body, offset),
+	};
+	strncpy(header.fingerprint, fingerprint ? fingerprint : "", sizeof(header.fingerprint) - 1);
+
+	char tmp_path[PATH_MAX];
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, (int)getpid()) >= (int)sizeof(tmp_path)) {
+		free(body);
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	FILE * const file = fopen(tmp_path, "wb");
+	if (file == NULL) {
+		free(body);
+		return -1;
+	}
+
+	const bool written = fwrite(&header, sizeof(header), 1, file) == 1 && (offset == 0 || fwrite(body, offset, 1, file) == 1);
+	free(body);
+	if (fclose(file) != 0 || !written || rename(tmp_path, path) != 0) {
+		const int err = errno;
+		unlink(tmp_path);
+		errno = err;
+		return -1;
+	}
+
+	return count;
+}
+
+int pycsh_param_cache_load(const char * path, int node, const char * fingerprint, unsigned int max_age_s) {
+
+	const int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return 0;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(param_cache_header_t)) {
+		close(fd);
+		return 0;
+	}
+
+	/* The fingerprint may miss changes to the list, so don't trust it forever. */
+	if (max_age_s > 0 && difftime(time(NULL), st.st_mtime) > max_age_s) {
+		close(fd);
+		return 0;
+	}
+
+	const size_t size = st.st_size;
+	const uint8_t * const map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return 0;
+	}
+
+	param_cache_header_t header;
+	memcpy(&header, map, sizeof(header));
+	header.fingerprint[sizeof(header.fingerprint) - 1] = '\0';
+
+	const uint8_t * const body = map + sizeof(header);
+	if (memcmp(header.magic, PARAM_CACHE_MAGIC, sizeof(PARAM_CACHE_MAGIC)) != 0
+		|| header.version != PARAM_CACHE_VERSION
+		|| header.node != node
+		|| strcmp(header.fingerprint, fingerprint ? fingerprint : "") != 0
+		|| header.body_len != size - sizeof(header)
+		|| pycsh_crc32c(0, body, header.body_len) != header.body_crc) {
+		munmap((void *)map, size);
+		return 0;  // Stale or corrupt, download again.
+	}
+
+	int added = 0;
+	size_t offset = 0;
+	for (uint32_t n = 0; n < header.count; n++) {
+
+		param_cache_record_t record;
+		if (offset + sizeof(record) > header.body_len) {
+			break;
+		}
+		memcpy(&record, &body[offset], sizeof(record));
+		offset += sizeof(record);
+
+		const size_t strings_len = (size_t)record.name_len + record.unit_len + record.help_len;
+		if (record.name_len == 0 || offset + strings_len > header.body_len) {
+			break;
+		}
+		/* Strings are NUL terminated in the file, and mapped privately, so they may be passed as is. */
+		char * const name = (char *)&body[offset];
+		char * const unit = record.unit_len ? (char *)&body[offset + record.name_len] : NULL;
+		char * const help = record.help_len ? (char *)&body[offset + record.name_len + record.unit_len] : NULL;
+		offset += strings_len;
+
+		if (name[record.name_len - 1] != '\0'
+			|| (unit && unit[record.unit_len - 1] != '\0')
+			|| (help && help[record.help_len - 1] != '\0')) {
+			break;
+		}
+
+		param_t * const param = param_list_create_remote(record.id, record.node, record.type, record.mask, record.array_size, name, unit, help, record.storage_type);
+		if (param == NULL) {
+			break;
+		}
+		/* libparam has no bulk add, so every add scans the list for duplicates. */
+		const int res = param_list_add(param);
+		if (res != 0) {
+			/* 1: Already in the list, which has now been updated from `param`. */
+			param_list_destroy(param);
+		}
+		if (res == 0 || res == 1) {
+			added++;
+		}
+	}
+
+	munmap((void *)map, size);
+	return added;
+}
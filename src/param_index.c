@@ -0,0 +1,240 @@
+/*
+ * param_index.c
+ *
+ * Hash index of the global parameter list, keyed by (node, name) and (node, id).
+ * Saves `param_list_find_name()` from string comparing every parameter in the list,
+ * for every `pycsh.get("name")`.
+ * The index holds raw `param_t` pointers, so anything removing parameters from the list
+ * must call `pycsh_param_index_invalidate()`, see param_index.h.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/param_index.h>
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <param/param_list.h>
+
+#include <pycsh/utils.h>
+
+/* Protects everything below, as lookups are made without the GIL on free-threaded builds. */
+static pycsh_mutex_t index_lock = PYCSH_MUTEX_INIT;
+
+/* Open addressing tables, each kept at most half full. */
+static const param_t ** name_table = NULL;
+static const param_t ** id_table = NULL;
+static size_t table_size = 0;  /* Power of 2 */
+static size_t index_entries = 0;
+static bool index_valid = false;
+static uint64_t index_generation = 0;
+
+static uint64_t index_hits = 0;
+static uint64_t index_misses = 0;
+static uint64_t index_rebuilds = 0;
+
+/* `param_list_find_*()` treats node -1 as the local node. */
+static inline int normalize_node(int node) {
+	return node == -1 ? 0 : node;
+}
+
+static uint32_t hash_name(int node, const char * name) {
+	/* FNV-1a */
+	uint32_t hash = 2166136261u ^ (uint32_t)node;
+	for (const char * c = name; *c; c++) {
+		hash ^= (uint8_t)*c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static uint32_t hash_id(int node, int id) {
+	uint32_t hash = ((uint32_t)node << 16) ^ (uint32_t)id;
+	/* Finalizer from MurmurHash3, as consecutive IDs would otherwise cluster. */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bu;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35u;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+static void index_insert(const param_t * param) {
+
+	const size_t mask = table_size - 1;
+
+	/* Keep the first match, like `param_list_find_*()` would. */
+	for (size_t slot = hash_name(*param->node, param->name) & mask; ; slot = (slot + 1) & mask) {
+		const param_t * const existing = name_table[slot];
+		if (existing == NULL) {
+			name_table[slot] = param;
+			break;
+		}
+		if (*existing->node == *param->node && strcmp(existing->name, param->name) == 0) {
+			break;
+		}
+	}
+
+	for (size_t slot = hash_id(*param->node, param->id) & mask; ; slot = (slot + 1) & mask) {
+		const param_t * const existing = id_table[slot];
+		if (existing == NULL) {
+			id_table[slot] = param;
+			break;
+		}
+		if (*existing->node == *param->node && existing->id == param->id) {
+			break;
+		}
+	}
+}
+
+/* Caller must hold `index_lock` */
+static bool index_rebuild(void) {
+
+	size_t count = 0;
+	param_list_iterator i = {0};
+	while (param_list_iterate(&i) != NULL) {
+		count++;
+	}
+
+	size_t size = 16;
+	while (size < count * 2) {
+		size *= 2;
+	}
+
+	if (size != table_size) {
+		const param_t ** const new_name_table = calloc(size, sizeof(*new_name_table));
+		const param_t ** const new_id_table = calloc(size, sizeof(*new_id_table));
+		if (new_name_table == NULL || new_id_table == NULL) {
+			free(new_name_table);
+			free(new_id_table);
+			return false;
+		}
+		free(name_table);
+		free(id_table);
+		name_table = new_name_table;
+		id_table = new_id_table;
+		table_size = size;
+	} else {
+		memset(name_table, 0, table_size * sizeof(*name_table));
+		memset(id_table, 0, table_size * sizeof(*id_table));
+	}
+
+	const param_t * param;
+	i = (param_list_iterator){0};
+	while ((param = param_list_iterate(&i)) != NULL) {
+		index_insert(param);
+	}
+
+	index_entries = count;
+	index_valid = true;
+	index_rebuilds++;
+	return true;
+}
+
+static bool index_ensure(void) {
+	return index_valid || index_rebuild();
+}
+
+const param_t * pycsh_param_index_find_name(int node, const char * name) {
+
+	node = normalize_node(node);
+
+	pycsh_mutex_lock(&index_lock);
+
+	if (index_ensure()) {
+		const size_t mask = table_size - 1;
+		for (size_t slot = hash_name(node, name) & mask; name_table[slot] != NULL; slot = (slot + 1) & mask) {
+			const param_t * const param = name_table[slot];
+			/* Compared in full, which also catches `param_t`s modified in-place since the index was built. */
+			if (*param->node == node && strcmp(param->name, name) == 0) {
+				index_hits++;
+				pycsh_mutex_unlock(&index_lock);
+				return param;
+			}
+		}
+	}
+
+	index_misses++;
+	const param_t * const param = param_list_find_name(node, (char*)name);
+	if (param != NULL) {
+		/* Added to the list without going through us, include it next time. */
+		index_valid = false;
+	}
+	pycsh_mutex_unlock(&index_lock);
+	return param;
+}
+
+const param_t * pycsh_param_index_find_id(int node, int id) {
+
+	node = normalize_node(node);
+
+	pycsh_mutex_lock(&index_lock);
+
+	if (index_ensure()) {
+		const size_t mask = table_size - 1;
+		for (size_t slot = hash_id(node, id) & mask; id_table[slot] != NULL; slot = (slot + 1) & mask) {
+			const param_t * const param = id_table[slot];
+			if (*param->node == node && param->id == id) {
+				index_hits++;
+				pycsh_mutex_unlock(&index_lock);
+				return param;
+			}
+		}
+	}
+
+	index_misses++;
+	const param_t * const param = param_list_find_id(node, id);
+	if (param != NULL) {
+		index_valid = false;
+	}
+	pycsh_mutex_unlock(&index_lock);
+	return param;
+}
+
+void pycsh_param_index_invalidate(void) {
+	pycsh_mutex_lock(&index_lock);
+	index_valid = false;
+	index_generation++;
+	pycsh_mutex_unlock(&index_lock);
+}
+
+uint64_t pycsh_param_index_generation(void) {
+	pycsh_mutex_lock(&index_lock);
+	const uint64_t generation = index_generation;
+	pycsh_mutex_unlock(&index_lock);
+	return generation;
+}
+
+PyObject * pycsh_param_index_stats(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int reset = 0;
+
+	static char *kwlist[] = {"reset", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p:list_index_stats", kwlist, &reset))
+		return NULL;  // TypeError is thrown
+
+	pycsh_mutex_lock(&index_lock);
+	const Py_ssize_t entries = index_valid ? index_entries : 0;
+	const uint64_t hits = index_hits;
+	const uint64_t misses = index_misses;
+	const uint64_t rebuilds = index_rebuilds;
+	if (reset) {
+		index_hits = 0;
+		index_misses = 0;
+		index_rebuilds = 0;
+	}
+	pycsh_mutex_unlock(&index_lock);
+
+	return Py_BuildValue("{s:n,s:K,s:K,s:K}",
+		"entries", entries,
+		"hits", (unsigned long long)hits,
+		"misses", (unsigned long long)misses,
+		"rebuilds", (unsigned long long)rebuilds
+	);
+}
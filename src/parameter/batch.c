@@ -0,0 +1,391 @@
+/*
+ * batch.c
+ *
+ * Contains the Batch class, returned by `pycsh.batch()`.
+ * Remote parameter writes made on the thread which entered the batch are queued rather than pushed,
+ * and are then pushed with as few packets as possible per destination when the batch exits.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/batch.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <param/param_queue.h>
+#include <param/param_server.h>
+
+#include <pycsh/pycsh.h>
+#include <pycsh/utils.h>
+#include <pycsh/stats.h>
+#include <pycsh/parameter.h>
+
+#define BATCH_VALUE_SIZE 128  // Size of the value buffer used by `_pycsh_util_set_single()`
+
+typedef struct {
+	const param_t * param;
+	int host;
+	int offset;
+	char value[BATCH_VALUE_SIZE] __attribute__((aligned(16)));
+} batch_entry_t;
+
+typedef struct BatchObject {
+	PyObject_HEAD
+
+	int node;  // INT_MIN to push to the node of each parameter.
+	int timeout;
+	int retries;
+	int paramver;
+	int verbose;
+	bool ack_with_pull;
+
+	/* Set while entered, writes are only batched on the thread which entered. */
+	bool active;
+	unsigned long thread_id;
+	struct BatchObject * prev;  // Enclosing batch, restored on exit.
+
+	batch_entry_t * entries;
+	size_t entry_count;
+	size_t entry_capacity;
+
+	/* list[tuple[Parameter, int | None, bool]] from the latest flush. */
+	PyObject * results;
+} BatchObject;
+
+/* Innermost batch entered by this thread. Thread-local, so free-threaded builds need no lock for it. */
+static _Thread_local BatchObject * active_batch = NULL;
+
+int pycsh_batch_add(const param_t * param, int offset, const void * value, int host) {
+
+	BatchObject * const self = active_batch;
+	if (self == NULL || self->thread_id != PyThread_get_thread_ident()) {
+		return 0;
+	}
+
+	if (self->entry_count >= self->entry_capacity) {
+		const size_t capacity = self->entry_capacity ? self->entry_capacity * 2 : 16;
+		batch_entry_t * const entries = realloc(self->entries, capacity * sizeof(*entries));
+		if (entries == NULL) {
+			PyErr_NoMemory();
+			return -1;
+		}
+		self->entries = entries;
+		self->entry_capacity = capacity;
+	}
+
+	batch_entry_t * const entry = &self->entries[self->entry_count++];
+	entry->param = param;
+	entry->host = (self->node != INT_MIN) ? self->node : host;
+	entry->offset = offset;
+	memcpy(entry->value, value, sizeof(entry->value));
+
+	return 1;
+}
+
+static void Batch_discard(BatchObject * self) {
+	self->entry_count = 0;
+}
+
+/* Push a filled queue, retrying as `_pycsh_util_set_single()` would. */
+static int Batch_push_chunk(BatchObject * self, param_queue_t * queue, const param_t ** params, size_t param_cnt, int host) {
+
+	int res = -1;
+	for (int i = 0; i < (self->retries > 0 ? self->retries : 1); i++) {
+		Py_BEGIN_ALLOW_THREADS;
+		res = pycsh_param_push_queue_params(queue, params, param_cnt, self->verbose, host, pycsh_stats_resolve_timeout(self->timeout, host, i, pycsh_dfl_timeout), self->ack_with_pull);
+		Py_END_ALLOW_THREADS;
+		if (res >= 0) {
+			break;
+		}
+		if (i < self->retries-1) {
+			pycsh_stats_retry(host, PYCSH_STATS_PUSH);
+		}
+	}
+	return res;
+}
+
+static int Batch_append_result(PyObject * results, const batch_entry_t * entry, bool acked) {
+
+	/* Returns the existing wrapper, if any. */
+	PyObject * const parameter AUTO_DECREF = pycsh_Parameter_from_param(&ParameterType, entry->param, NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
+	if (parameter == NULL) {
+		return -1;
+	}
+
+	PyObject * const offset AUTO_DECREF = (entry->offset < 0) ? Py_NewRef(Py_None) : PyLong_FromLong(entry->offset);
+	if (offset == NULL) {
+		return -1;
+	}
+
+	PyObject * const result AUTO_DECREF = PyTuple_Pack(3, parameter, offset, acked ? Py_True : Py_False);
+	if (result == NULL) {
+		return -1;
+	}
+	return PyList_Append(results, result);
+}
+
+/**
+ * @brief Push all queued writes, grouped by destination and packed into as few packets as possible.
+ *
+ * Writes to the same destination are pushed in the order they were made.
+ * A write is considered acknowledged when the packet it was sent in was.
+ *
+ * @return Number of writes which were not acknowledged, or -1 with an exception set.
+ */
+static Py_ssize_t Batch_flush_internal(BatchObject * self) {
+
+	PyObject * const results AUTO_DECREF = PyList_New(0);
+	if (results == NULL) {
+		return -1;
+	}
+
+	const size_t entry_count = self->entry_count;
+	bool * const pushed = calloc(entry_count > 0 ? entry_count : 1, sizeof(*pushed));
+	bool * const acked = calloc(entry_count > 0 ? entry_count : 1, sizeof(*acked));
+	const param_t ** const chunk_params = malloc((entry_count > 0 ? entry_count : 1) * sizeof(*chunk_params));
+	size_t * const chunk_entries = malloc((entry_count > 0 ? entry_count : 1) * sizeof(*chunk_entries));
+	if (pushed == NULL || acked == NULL || chunk_params == NULL || chunk_entries == NULL) {
+		free(pushed);
+		free(acked);
+		free(chunk_params);
+		free(chunk_entries);
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	uint8_t queuebuffer[PARAM_SERVER_MTU] = {0};
+	param_queue_t queue;
+
+	for (size_t first = 0; first < entry_count; first++) {
+
+		if (pushed[first]) {
+			continue;
+		}
+		const int host = self->entries[first].host;
+
+		param_queue_init(&queue, queuebuffer, PARAM_SERVER_MTU - 2, 0, PARAM_QUEUE_TYPE_SET, self->paramver);
+		size_t chunk_cnt = 0;
+
+		for (size_t i = first; i <= entry_count; i++) {
+
+			batch_entry_t * const entry = (i < entry_count) ? &self->entries[i] : NULL;
+			if (entry != NULL && (pushed[i] || entry->host != host)) {
+				continue;
+			}
+
+			/* Push the chunk when the next write does not fit, or when there are no more writes for this destination. */
+			if (entry == NULL || param_queue_add(&queue, entry->param, entry->offset, entry->value) < 0) {
+
+				if (chunk_cnt > 0) {
+					const bool ok = Batch_push_chunk(self, &queue, chunk_params, chunk_cnt, host) >= 0;
+					for (size_t j = 0; j < chunk_cnt; j++) {
+						acked[chunk_entries[j]] = ok;
+					}
+				}
+
+				if (entry == NULL) {
+					break;
+				}
+
+				param_queue_init(&queue, queuebuffer, PARAM_SERVER_MTU - 2, 0, PARAM_QUEUE_TYPE_SET, self->paramver);
+				chunk_cnt = 0;
+				if (param_queue_add(&queue, entry->param, entry->offset, entry->value) < 0) {
+					pushed[i] = true;  // Does not fit in a packet on its own, so it can never be acknowledged.
+					continue;
+				}
+			}
+
+			pushed[i] = true;
+			chunk_params[chunk_cnt] = entry->param;
+			chunk_entries[chunk_cnt] = i;
+			chunk_cnt++;
+		}
+	}
+
+	Py_ssize_t failed = 0;
+	for (size_t i = 0; i < entry_count; i++) {
+		if (!acked[i]) {
+			failed++;
+		} else if (self->verbose > -1) {
+			param_print(self->entries[i].param, self->entries[i].offset, NULL, 0, 2, 0);
+		}
+		if (Batch_append_result(results, &self->entries[i], acked[i]) < 0) {
+			failed = -1;
+			break;
+		}
+	}
+
+	free(pushed);
+	free(acked);
+	free(chunk_params);
+	free(chunk_entries);
+	Batch_discard(self);
+
+	if (failed >= 0) {
+		Py_XSETREF(self->results, Py_NewRef(results));
+	}
+	return failed;
+}
+
+static void Batch_deactivate(BatchObject * self) {
+	if (!self->active) {
+		return;
+	}
+	active_batch = self->prev;
+	self->prev = NULL;
+	self->active = false;
+	Py_DECREF(self);  // Reference held by `active_batch`
+}
+
+static void Batch_dealloc(BatchObject * self) {
+	/* Can't be active, as `active_batch` holds a reference while it is. */
+	free(self->entries);
+	Py_XDECREF(self->results);
+	Py_TYPE(self)->tp_free((PyObject *) self);
+}
+
+static PyObject * Batch_enter(BatchObject * self, PyObject * Py_UNUSED(ignored)) {
+
+	if (self->active) {
+		PyErr_SetString(PyExc_RuntimeError, "Batch is already entered");
+		return NULL;
+	}
+
+	self->active = true;
+	self->thread_id = PyThread_get_thread_ident();
+	self->prev = active_batch;
+	active_batch = (BatchObject *)Py_NewRef(self);
+
+	return Py_NewRef(self);
+}
+
+static PyObject * Batch_exit(BatchObject * self, PyObject * args) {
+
+	PyObject * exc_type = Py_None;
+	PyObject * exc_value = Py_None;
+	PyObject * traceback = Py_None;
+	if (!PyArg_ParseTuple(args, "|OOO:__exit__", &exc_type, &exc_value, &traceback)) {
+		return NULL;  // TypeError is thrown
+	}
+
+	if (active_batch != self) {
+		PyErr_SetString(PyExc_RuntimeError, "Batches must be exited in the reverse order they were entered");
+		return NULL;
+	}
+
+	/* Writes made by callbacks during the flush should go to the enclosing batch, if any. */
+	Py_INCREF(self);
+	Batch_deactivate(self);
+	PyObject * const self_ref AUTO_DECREF = (PyObject *)self;
+
+	if (exc_type != Py_None) {
+		Batch_discard(self);  // The block failed, so none of its writes are pushed.
+		Py_RETURN_FALSE;
+	}
+
+	const Py_ssize_t failed = Batch_flush_internal(self);
+	if (failed < 0) {
+		return NULL;
+	}
+	if (failed > 0) {
+		PyErr_Format(PyExc_ConnectionError, "%zd of %zd parameter writes were not acknowledged, see Batch.results", failed, PyList_GET_SIZE(self->results));
+		return NULL;
+	}
+
+	Py_RETURN_FALSE;
+}
+
+static PyObject * Batch_flush(BatchObject * self, PyObject * Py_UNUSED(ignored)) {
+
+	if (Batch_flush_internal(self) < 0) {
+		return NULL;
+	}
+	return Py_NewRef(self->results);
+}
+
+static PyObject * Batch_discard_py(BatchObject * self, PyObject * Py_UNUSED(ignored)) {
+	Batch_discard(self);
+	Py_RETURN_NONE;
+}
+
+static PyObject * Batch_get_results(BatchObject * self, void * closure) {
+	return Py_NewRef(self->results);
+}
+
+static Py_ssize_t Batch_length(BatchObject * self) {
+	return self->entry_count;
+}
+
+PyObject * pycsh_batch(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int node = INT_MIN;
+	int timeout = pycsh_dfl_timeout;
+	int retries = 1;
+	int paramver = 2;
+	int verbose = -1;
+	int ack_with_pull = true;
+
+	static char *kwlist[] = {"node", "ack_with_pull", "timeout", "retries", "paramver", "verbose", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ipO&iii:batch", kwlist, &node, &ack_with_pull, pycsh_parse_timeout, &timeout, &retries, &paramver, &verbose))
+		return NULL;  // TypeError is thrown
+
+	BatchObject * const batch = (BatchObject *)BatchType.tp_alloc(&BatchType, 0);
+	if (batch == NULL) {
+		return NULL;
+	}
+
+	batch->node = node;
+	batch->timeout = timeout;
+	batch->retries = retries;
+	batch->paramver = paramver;
+	batch->verbose = verbose;
+	batch->ack_with_pull = ack_with_pull;
+	batch->results = PyList_New(0);
+	if (batch->results == NULL) {
+		Py_DECREF(batch);
+		return NULL;
+	}
+
+	return (PyObject *)batch;
+}
+
+static PySequenceMethods Batch_as_sequence = {
+	.sq_length = (lenfunc)Batch_length,
+};
+
+static PyGetSetDef Batch_getsetters[] = {
+	{"results", (getter)Batch_get_results, NULL,
+     "(Parameter, offset, acknowledged) of each write pushed by the latest flush.", NULL},
+    {NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef Batch_methods[] = {
+	{"flush", (PyCFunction)Batch_flush, METH_NOARGS,
+     PyDoc_STR("Push the writes queued so far, and return their results.")},
+	{"discard", (PyCFunction)Batch_discard_py, METH_NOARGS,
+     PyDoc_STR("Drop the writes queued so far, without pushing them.")},
+	{"__enter__", (PyCFunction)Batch_enter, METH_NOARGS, NULL},
+	{"__exit__", (PyCFunction)Batch_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
+PyTypeObject BatchType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "pycsh.Batch",
+	.tp_doc = "Queues remote parameter writes while entered, returned by pycsh.batch().",
+	.tp_basicsize = sizeof(BatchObject),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_dealloc = (destructor)Batch_dealloc,
+	.tp_as_sequence = &Batch_as_sequence,
+	.tp_methods = Batch_methods,
+	.tp_getset = Batch_getsetters,
+};
@@ -0,0 +1,252 @@
+/*
+ * callback_filter.c
+ *
+ * Per-parameter filters for Parameter callbacks, evaluated by `Parameter_callback()` before it takes the GIL.
+ * Telemetry pulls and the parameter sniffer apply values much more often than they change,
+ * so this saves acquiring the GIL for most of them.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/callback_filter.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <pycsh/utils.h>
+#include <pycsh/stats.h>
+
+typedef struct {
+	const param_t * param;
+
+	bool on_change;
+	double deadband;
+	double rel_deadband;
+	uint64_t min_interval_us;
+
+	uint64_t last_pass_us;  // 0 before the first value passed
+	uint64_t filtered;
+
+	/* Last passed value of each element of numeric parameters. */
+	int count;
+	double * last;
+	bool * has_last;
+	/* Hash of the last passed value of string and data parameters. */
+	uint64_t last_hash;
+	bool has_last_hash;
+} callback_filter_t;
+
+static pthread_mutex_t filter_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int filter_count = 0;
+/* Sorted by `param`, for bsearch() */
+static callback_filter_t ** filters = NULL;
+static size_t filters_capacity = 0;
+
+static int filter_compare(const void * a, const void * b) {
+	const param_t * const pa = (*(callback_filter_t * const *)a)->param;
+	const param_t * const pb = (*(callback_filter_t * const *)b)->param;
+	return (pa > pb) - (pa < pb);
+}
+
+/* Caller must hold `filter_lock` */
+static callback_filter_t ** filter_find(const param_t * param) {
+	const callback_filter_t key = {.param = param};
+	const callback_filter_t * const key_ptr = &key;
+	return bsearch(&key_ptr, filters, atomic_load(&filter_count), sizeof(*filters), filter_compare);
+}
+
+static void filter_free(callback_filter_t * filter) {
+	free(filter->last);
+	free(filter->has_last);
+	free(filter);
+}
+
+static bool is_numeric(const param_t * param) {
+	return param->type != PARAM_TYPE_STRING && param->type != PARAM_TYPE_DATA;
+}
+
+/* FNV-1a of the whole value */
+static uint64_t value_hash(const param_t * param) {
+
+	const int len = param->array_size > 0 ? param->array_size : 1;
+	uint8_t stackbuf[256];
+	uint8_t * const buf = (len <= (int)sizeof(stackbuf)) ? stackbuf : malloc(len);
+	if (buf == NULL) {
+		return 0;
+	}
+	param_get_data((param_t *)param, buf, len);
+
+	uint64_t hash = 14695981039346656037ULL;
+	for (int i = 0; i < len; i++) {
+		hash = (hash ^ buf[i]) * 1099511628211ULL;
+	}
+
+	if (buf != stackbuf) {
+		free(buf);
+	}
+	return hash;
+}
+
+/* Caller must hold `filter_lock`. Remembers the new values when they pass. */
+static bool filter_value_changed(callback_filter_t * filter, int offset) {
+
+	const param_t * const param = filter->param;
+
+	if (!is_numeric(param)) {
+		if (!filter->on_change) {
+			return true;  // Deadbands don't apply
+		}
+		const uint64_t hash = value_hash(param);
+		if (filter->has_last_hash && hash == filter->last_hash) {
+			return false;
+		}
+		filter->last_hash = hash;
+		filter->has_last_hash = true;
+		return true;
+	}
+
+	const int first = (offset >= 0 && offset < filter->count) ? offset : 0;
+	const int end = (offset >= 0 && offset < filter->count) ? offset + 1 : filter->count;
+
+	bool changed = false;
+	for (int i = first; i < end && !changed; i++) {
+		if (!filter->has_last[i]) {
+			changed = true;
+			break;
+		}
+		const double value = pycsh_param_get_double(param, i);
+		const double last = filter->last[i];
+		const double threshold = fmax(filter->deadband, filter->rel_deadband * fabs(last));
+		changed = fabs(value - last) > threshold || (isnan(value) != isnan(last));
+	}
+
+	if (changed) {
+		for (int i = first; i < end; i++) {
+			filter->last[i] = pycsh_param_get_double(param, i);
+			filter->has_last[i] = true;
+		}
+	}
+	return changed;
+}
+
+bool pycsh_callback_filter_pass(const param_t * param, int offset) {
+
+	if (atomic_load_explicit(&filter_count, memory_order_relaxed) == 0) {
+		return true;
+	}
+
+	pthread_mutex_lock(&filter_lock);
+
+	callback_filter_t ** const found = filter_find(param);
+	if (found == NULL) {
+		pthread_mutex_unlock(&filter_lock);
+		return true;
+	}
+	callback_filter_t * const filter = *found;
+
+	const uint64_t now_us = pycsh_stats_now_us();
+	bool pass = !(filter->last_pass_us != 0 && filter->min_interval_us > 0 && now_us - filter->last_pass_us < filter->min_interval_us);
+
+	if (pass && (filter->on_change || filter->deadband > 0 || filter->rel_deadband > 0)) {
+		pass = filter_value_changed(filter, offset);
+	}
+
+	if (pass) {
+		filter->last_pass_us = now_us;
+	} else {
+		filter->filtered++;
+	}
+
+	pthread_mutex_unlock(&filter_lock);
+	return pass;
+}
+
+int pycsh_callback_filter_set(const param_t * param, bool on_change, double deadband, double rel_deadband, uint32_t min_interval_ms) {
+
+	if (!on_change && deadband <= 0 && rel_deadband <= 0 && min_interval_ms == 0) {
+		pycsh_callback_filter_remove(param);
+		return 0;
+	}
+
+	callback_filter_t * const filter = calloc(1, sizeof(*filter));
+	if (filter == NULL) {
+		return -1;
+	}
+	filter->param = param;
+	filter->on_change = on_change;
+	filter->deadband = deadband > 0 ? deadband : 0;
+	filter->rel_deadband = rel_deadband > 0 ? rel_deadband : 0;
+	filter->min_interval_us = (uint64_t)min_interval_ms * 1000;
+	if (is_numeric(param)) {
+		filter->count = param->array_size > 0 ? param->array_size : 1;
+		filter->last = calloc(filter->count, sizeof(*filter->last));
+		filter->has_last = calloc(filter->count, sizeof(*filter->has_last));
+		if (filter->last == NULL || filter->has_last == NULL) {
+			filter_free(filter);
+			return -1;
+		}
+	}
+
+	pthread_mutex_lock(&filter_lock);
+
+	callback_filter_t ** const found = filter_find(param);
+	if (found != NULL) {
+		filter_free(*found);
+		*found = filter;
+		pthread_mutex_unlock(&filter_lock);
+		return 0;
+	}
+
+	const size_t count = atomic_load(&filter_count);
+	if (count >= filters_capacity) {
+		const size_t capacity = filters_capacity ? filters_capacity * 2 : 16;
+		callback_filter_t ** const resized = realloc(filters, capacity * sizeof(*filters));
+		if (resized == NULL) {
+			pthread_mutex_unlock(&filter_lock);
+			filter_free(filter);
+			return -1;
+		}
+		filters = resized;
+		filters_capacity = capacity;
+	}
+	filters[count] = filter;
+	qsort(filters, count + 1, sizeof(*filters), filter_compare);
+	atomic_store(&filter_count, count + 1);
+
+	pthread_mutex_unlock(&filter_lock);
+	return 0;
+}
+
+void pycsh_callback_filter_remove(const param_t * param) {
+
+	if (atomic_load_explicit(&filter_count, memory_order_relaxed) == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&filter_lock);
+	callback_filter_t ** const found = filter_find(param);
+	if (found != NULL) {
+		filter_free(*found);
+		const size_t count = atomic_load(&filter_count);
+		memmove(found, found + 1, (&filters[count] - (found + 1)) * sizeof(*filters));
+		atomic_store(&filter_count, count - 1);
+	}
+	pthread_mutex_unlock(&filter_lock);
+}
+
+uint64_t pycsh_callback_filter_filtered(const param_t * param) {
+
+	if (atomic_load_explicit(&filter_count, memory_order_relaxed) == 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&filter_lock);
+	callback_filter_t ** const found = filter_find(param);
+	const uint64_t filtered = found ? (*found)->filtered : 0;
+	pthread_mutex_unlock(&filter_lock);
+	return filtered;
+}
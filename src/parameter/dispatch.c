@@ -0,0 +1,348 @@
+/*
+ * dispatch.c
+ *
+ * Deferred dispatch of Parameter callbacks.
+ * Threads which apply values without holding the GIL (typically the router),
+ * push the callback onto a lock-free MPSC queue, rather than waiting for the GIL themselves.
+ * A dedicated thread then calls the Python callbacks in the order they were queued.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/dispatch.h>
+
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+
+#include <pycsh/utils.h>
+#include <pycsh/stats.h>
+#include <pycsh/parameter.h>
+
+#define DISPATCH_DEFAULT_MAXLEN 4096
+
+/* Callbacks to call per acquisition of the GIL, when more are pending. */
+#define DISPATCH_BURST 64
+
+/* Number of generation counters, which param_t addresses are hashed onto. */
+#define DISPATCH_GENERATIONS 1024
+
+typedef struct dispatch_node_s {
+	_Atomic(struct dispatch_node_s *) next;
+	const param_t * param;  // NULL tells the dispatcher thread to stop.
+	int offset;
+	uint32_t generation;
+	uint64_t enqueued_us;
+} dispatch_node_t;
+
+/* Bumped by `pycsh_dispatch_forget()`. A node whose generation no longer matches may point to a freed param_t,
+	or one reallocated at the same address, so its callback is skipped.
+	Parameters sharing a counter only cost an unnecessary skip, when one of them is deleted while the other has callbacks queued. */
+static _Atomic uint32_t generations[DISPATCH_GENERATIONS];
+
+/* Vyukov MPSC queue: producers exchange `queue_head`, only the dispatcher thread pops from `queue_tail`. */
+static dispatch_node_t queue_stub;
+static _Atomic(dispatch_node_t *) queue_head = &queue_stub;
+static dispatch_node_t * queue_tail = &queue_stub;
+/* Posted once per queued node. */
+static sem_t queue_sem;
+
+static atomic_bool deferred = false;
+/* Producers between checking `deferred` and pushing their node, which `dispatch_stop()` waits for. */
+static atomic_int producers = 0;
+static _Atomic size_t maxlen = DISPATCH_DEFAULT_MAXLEN;
+
+/* Protected by `thread_lock`, which is held while `dispatch_stop()` waits without the GIL,
+	so it must be a real mutex, and must be taken without the GIL. Read without it for stats. */
+static pthread_mutex_t thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool thread_running = false;
+static pthread_t dispatch_thread;
+
+static _Atomic uint64_t depth = 0;
+static _Atomic uint64_t max_depth = 0;
+static _Atomic uint64_t enqueued = 0;
+static _Atomic uint64_t dispatched = 0;
+static _Atomic uint64_t dropped = 0;
+static _Atomic uint64_t latency_us_total = 0;
+static _Atomic uint64_t latency_us_max = 0;
+
+static void queue_push(dispatch_node_t * node) {
+	atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+	dispatch_node_t * const prev = atomic_exchange_explicit(&queue_head, node, memory_order_acq_rel);
+	atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+/* Only called by the dispatcher thread. May return NULL while a push is half done. */
+static dispatch_node_t * queue_pop(void) {
+
+	dispatch_node_t * tail = queue_tail;
+	dispatch_node_t * next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+	if (tail == &queue_stub) {
+		if (next == NULL) {
+			return NULL;
+		}
+		queue_tail = tail = next;
+		next = atomic_load_explicit(&next->next, memory_order_acquire);
+	}
+
+	if (next != NULL) {
+		queue_tail = next;
+		return tail;
+	}
+
+	if (tail != atomic_load_explicit(&queue_head, memory_order_acquire)) {
+		return NULL;
+	}
+
+	queue_push(&queue_stub);
+	next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if (next != NULL) {
+		queue_tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+static _Atomic uint32_t * generation_of(const param_t * param) {
+	return &generations[((uintptr_t)param >> 4) % DISPATCH_GENERATIONS];
+}
+
+static void atomic_max(_Atomic uint64_t * target, uint64_t value) {
+	uint64_t current = atomic_load_explicit(target, memory_order_relaxed);
+	while (value > current && !atomic_compare_exchange_weak_explicit(target, &current, value, memory_order_relaxed, memory_order_relaxed));
+}
+
+static void push_node(dispatch_node_t * node) {
+	atomic_max(&max_depth, atomic_fetch_add_explicit(&depth, 1, memory_order_relaxed) + 1);
+	queue_push(node);
+	sem_post(&queue_sem);
+}
+
+bool pycsh_dispatch_enqueue(const param_t * param, int offset) {
+
+	if (PyGILState_Check()) {
+		return false;
+	}
+
+	/* Announce ourselves before checking `deferred`, so `dispatch_stop()` either sees us, or we see it stopping.
+		Both are sequentially consistent for that reason. */
+	atomic_fetch_add(&producers, 1);
+	if (!atomic_load(&deferred)) {
+		atomic_fetch_sub(&producers, 1);
+		return false;
+	}
+
+	dispatch_node_t * node = NULL;
+	if (atomic_load_explicit(&depth, memory_order_relaxed) < atomic_load_explicit(&maxlen, memory_order_relaxed)) {
+		node = malloc(sizeof(*node));
+	}
+	if (node == NULL) {
+		atomic_fetch_sub(&producers, 1);
+		atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+		return true;
+	}
+	node->param = param;
+	node->offset = offset;
+	node->generation = atomic_load_explicit(generation_of(param), memory_order_acquire);
+	node->enqueued_us = pycsh_stats_now_us();
+
+	atomic_fetch_add_explicit(&enqueued, 1, memory_order_relaxed);
+	push_node(node);
+	atomic_fetch_sub(&producers, 1);
+	return true;
+}
+
+void pycsh_dispatch_forget(const param_t * param) {
+	atomic_fetch_add_explicit(generation_of(param), 1, memory_order_release);
+}
+
+/* Wait for the next node, which must have been counted by `queue_sem` */
+static dispatch_node_t * dispatch_next(void) {
+	dispatch_node_t * node;
+	while ((node = queue_pop()) == NULL) {
+		sched_yield();  // A producer is between its exchange and its link.
+	}
+	atomic_fetch_sub_explicit(&depth, 1, memory_order_relaxed);
+	return node;
+}
+
+static void * dispatch_task(void * arg) {
+	(void)arg;
+
+	while (true) {
+
+		while (sem_wait(&queue_sem) < 0 && errno == EINTR);
+		dispatch_node_t * node = dispatch_next();
+
+		PyGILState_STATE gstate = PyGILState_Ensure();
+
+		for (int i = 0; ; i++) {
+
+			if (node->param == NULL) {
+				free(node);
+				PyGILState_Release(gstate);
+				return NULL;
+			}
+
+			const uint64_t latency_us = pycsh_stats_now_us() - node->enqueued_us;
+			atomic_fetch_add_explicit(&latency_us_total, latency_us, memory_order_relaxed);
+			atomic_max(&latency_us_max, latency_us);
+
+			/* The Parameter may have been deleted while the callback was queued,
+				in which case `node->param` must not be touched. */
+			if (node->generation == atomic_load_explicit(generation_of(node->param), memory_order_acquire)
+					&& Parameter_wraps_param(node->param) != NULL) {
+				Parameter_callback_invoke(node->param, node->offset);
+				if (PyErr_Occurred()) {
+					PyErr_Print();  // There is no one but us to catch it.
+				}
+			}
+			atomic_fetch_add_explicit(&dispatched, 1, memory_order_relaxed);
+			free(node);
+
+			/* Keep the GIL for the rest of a burst. */
+			if (i >= DISPATCH_BURST-1 || sem_trywait(&queue_sem) < 0) {
+				break;
+			}
+			node = dispatch_next();
+		}
+
+		PyGILState_Release(gstate);
+	}
+}
+
+static int dispatch_start(void) {
+
+	static bool sem_initialized = false;
+	if (!sem_initialized) {
+		if (sem_init(&queue_sem, 0, 0) < 0) {
+			PyErr_SetFromErrno(PyExc_OSError);
+			return -1;
+		}
+		sem_initialized = true;
+	}
+
+	const int res = pthread_create(&dispatch_thread, NULL, dispatch_task, NULL);
+	if (res != 0) {
+		errno = res;
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+	thread_running = true;
+	atomic_store_explicit(&deferred, true, memory_order_release);
+	return 0;
+}
+
+/* Calls the callbacks still queued, before returning. */
+static int dispatch_stop(void) {
+
+	dispatch_node_t * const sentinel = calloc(1, sizeof(*sentinel));
+	if (sentinel == NULL) {
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	atomic_store(&deferred, false);
+
+	Py_BEGIN_ALLOW_THREADS;  // The dispatcher thread needs the GIL to drain the queue.
+	/* Producers which saw `deferred` before we cleared it must push their node ahead of the sentinel.
+		They never block, so this is brief. */
+	while (atomic_load(&producers) > 0) {
+		sched_yield();
+	}
+	push_node(sentinel);
+	pthread_join(dispatch_thread, NULL);
+	Py_END_ALLOW_THREADS;
+	thread_running = false;
+	return 0;
+}
+
+PyObject * pycsh_callback_dispatch(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	PyObject * deferred_obj = Py_None;
+	Py_ssize_t new_maxlen = -1;
+
+	static char *kwlist[] = {"deferred", "maxlen", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|On:callback_dispatch", kwlist, &deferred_obj, &new_maxlen))
+		return NULL;  // TypeError is thrown
+
+	if (new_maxlen == 0 || new_maxlen < -1) {
+		PyErr_SetString(PyExc_ValueError, "maxlen must be at least 1");
+		return NULL;
+	}
+	if (new_maxlen > 0) {
+		atomic_store_explicit(&maxlen, new_maxlen, memory_order_relaxed);
+	}
+
+	if (deferred_obj == Py_None) {
+		return PyBool_FromLong(thread_running);
+	}
+
+	const int enable = PyObject_IsTrue(deferred_obj);
+	if (enable < 0) {
+		return NULL;
+	}
+
+	/* `thread_running` can't change under the dispatcher thread, which `dispatch_stop()` would be waiting for,
+		and it must not wait for `thread_lock`, while `dispatch_stop()` holds it waiting for us. */
+	if (thread_running && pthread_equal(pthread_self(), dispatch_thread)) {
+		if (!enable) {
+			PyErr_SetString(PyExc_RuntimeError, "Deferred dispatch cannot be disabled from a callback it is dispatching");
+			return NULL;
+		}
+		Py_RETURN_TRUE;
+	}
+
+	Py_BEGIN_ALLOW_THREADS;  // Another thread may hold `thread_lock` while stopping, and need the GIL to do so.
+	pthread_mutex_lock(&thread_lock);
+	Py_END_ALLOW_THREADS;
+	int res = 0;
+	if (enable && !thread_running) {
+		res = dispatch_start();
+	} else if (!enable && thread_running) {
+		res = dispatch_stop();
+	}
+	const bool running = thread_running;
+	pthread_mutex_unlock(&thread_lock);
+
+	if (res < 0) {
+		return NULL;
+	}
+	return PyBool_FromLong(running);
+}
+
+static uint64_t counter_read(_Atomic uint64_t * counter, bool reset) {
+	if (reset) {
+		return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+	}
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+PyObject * pycsh_callback_dispatch_stats(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int reset = 0;
+
+	static char *kwlist[] = {"reset", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p:callback_dispatch_stats", kwlist, &reset))
+		return NULL;  // TypeError is thrown
+
+	return Py_BuildValue("{s:O,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+		"deferred", thread_running ? Py_True : Py_False,
+		"depth", (unsigned long long)atomic_load_explicit(&depth, memory_order_relaxed),
+		"max_depth", (unsigned long long)counter_read(&max_depth, reset),
+		"enqueued", (unsigned long long)counter_read(&enqueued, reset),
+		"dispatched", (unsigned long long)counter_read(&dispatched, reset),
+		"dropped", (unsigned long long)counter_read(&dropped, reset),
+		"latency_us_total", (unsigned long long)counter_read(&latency_us_total, reset),
+		"latency_us_max", (unsigned long long)counter_read(&latency_us_max, reset)
+	);
+}
@@ -0,0 +1,567 @@
+/*
+ * history.c
+ *
+ * Contains the ParameterHistory class, returned by `pycsh.history()`.
+ * Keeps the last N received values of selected parameters in memory,
+ * so recent trends can be inspected without querying an external database.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/history.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include <csp/csp.h>
+#include <csp/csp_hooks.h>
+#include <param/param_list.h>
+
+#include <pycsh/pycsh.h>
+#include <pycsh/utils.h>
+#include <pycsh/parameter.h>
+
+/**
+ * Every sample is written twice, at `i` and `i + capacity`,
+ * so the newest `capacity` samples are always contiguous in memory.
+ * This lets us export windows of the ring buffer without copying them.
+ */
+typedef struct {
+	atomic_int refcount;
+	int node;
+	int id;
+	uint32_t mask;
+	param_type_e type;
+	char * name;
+	int elements;
+	size_t capacity;
+	uint64_t count;  // Total number of samples recorded
+	/* Timestamps row followed by one row per element, each row `2 * capacity` doubles. */
+	double * data;
+} pycsh_history_t;
+
+typedef struct {
+	int node;
+	int id;
+	/* NULL when history is not enabled for this parameter */
+	pycsh_history_t * history;
+	bool used;
+} history_slot_t;
+
+typedef struct {
+	int node;
+	uint32_t mask;
+	char * globstr;
+	pycsh_glob_t glob;
+	size_t capacity;
+} history_rule_t;
+
+/* Protects rules, the table and the ring buffers of all histories. */
+static pthread_mutex_t history_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int rule_count = 0;
+static history_rule_t * rules = NULL;
+static history_slot_t * table = NULL;
+static size_t table_size = 0;
+static size_t table_used = 0;
+
+static void history_decref(pycsh_history_t * history) {
+	if (history == NULL || atomic_fetch_sub(&history->refcount, 1) > 1) {
+		return;
+	}
+	free(history->name);
+	free(history->data);
+	free(history);
+}
+
+/* Caller must hold `history_lock`. The last matching rule wins. */
+static size_t history_capacity_for(int node, uint32_t mask, const char * name, param_type_e type) {
+
+	if (type == PARAM_TYPE_STRING || type == PARAM_TYPE_DATA) {
+		return 0;  // Not a time-series
+	}
+
+	size_t capacity = 0;
+	const int count = atomic_load(&rule_count);
+	for (int i = 0; i < count; i++) {
+		const history_rule_t * const rule = &rules[i];
+		if ((rule->node >= 0) && (rule->node != node)) {
+			continue;
+		}
+		if ((mask & rule->mask) == 0) {
+			continue;
+		}
+		if (!pycsh_glob_match(&rule->glob, name)) {
+			continue;
+		}
+		capacity = rule->capacity;
+	}
+	return capacity;
+}
+
+static pycsh_history_t * history_new(const param_t * param, size_t capacity) {
+
+	pycsh_history_t * history = calloc(1, sizeof(*history));
+	if (history == NULL) {
+		return NULL;
+	}
+	atomic_init(&history->refcount, 1);
+	history->node = *param->node;
+	history->id = param->id;
+	history->mask = param->mask;
+	history->type = param->type;
+	history->elements = param->array_size > 0 ? param->array_size : 1;
+	history->capacity = capacity;
+	history->name = strdup(param->name);
+	history->data = calloc((history->elements + 1) * 2 * capacity, sizeof(*history->data));
+
+	if (history->name == NULL || history->data == NULL) {
+		history_decref(history);
+		return NULL;
+	}
+	return history;
+}
+
+static size_t slot_hash(int node, int id) {
+	return ((uint32_t)node * 2654435761u) ^ ((uint32_t)id * 40503u);
+}
+
+/* Caller must hold `history_lock` */
+static history_slot_t * table_find(int node, int id) {
+	if (table_size == 0) {
+		return NULL;
+	}
+	for (size_t i = slot_hash(node, id) & (table_size - 1);; i = (i + 1) & (table_size - 1)) {
+		if (!table[i].used) {
+			return NULL;
+		}
+		if (table[i].node == node && table[i].id == id) {
+			return &table[i];
+		}
+	}
+}
+
+/* Caller must hold `history_lock`. Takes ownership of a reference to `history`. */
+static void table_insert(history_slot_t * slots, size_t size, int node, int id, pycsh_history_t * history) {
+	for (size_t i = slot_hash(node, id) & (size - 1);; i = (i + 1) & (size - 1)) {
+		if (!slots[i].used) {
+			slots[i] = (history_slot_t){.node = node, .id = id, .history = history, .used = true};
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Rebuild the table, keeping only the histories whose capacity is unchanged by the current rules.
+ *
+ * Caller must hold `history_lock`.
+ * Histories which are dropped stay alive for as long as ParameterHistory objects reference them,
+ * they just stop receiving values.
+ */
+static int table_rebuild(size_t min_size) {
+
+	size_t size = 64;
+	while (size < min_size * 2) {
+		size *= 2;
+	}
+
+	history_slot_t * slots = calloc(size, sizeof(*slots));
+	if (slots == NULL) {
+		return -1;
+	}
+
+	size_t used = 0;
+	for (size_t i = 0; i < table_size; i++) {
+		pycsh_history_t * const history = table[i].history;
+		if (!table[i].used || history == NULL) {
+			continue;  // Re-evaluated against the new rules on the next value
+		}
+		if (history_capacity_for(history->node, history->mask, history->name, history->type) != history->capacity) {
+			history_decref(history);
+			continue;
+		}
+		table_insert(slots, size, table[i].node, table[i].id, history);
+		used++;
+	}
+
+	free(table);
+	table = slots;
+	table_size = size;
+	table_used = used;
+	return 0;
+}
+
+/* Caller must hold `history_lock`. Returns a borrowed reference, or NULL when history is not enabled for `param`. */
+static pycsh_history_t * history_get(const param_t * param) {
+
+	const int node = *param->node;
+
+	history_slot_t * const slot = table_find(node, param->id);
+	if (slot != NULL) {
+		return slot->history;
+	}
+
+	if ((table_used + 1) * 2 > table_size) {
+		/* Everything kept by the rebuild still matches the current rules. */
+		if (table_rebuild(table_used + 1) < 0) {
+			return NULL;
+		}
+	}
+
+	const size_t capacity = history_capacity_for(node, param->mask, param->name, param->type);
+	/* Also remember parameters without history, so we don't match rules for every one of their values. */
+	pycsh_history_t * const history = capacity > 0 ? history_new(param, capacity) : NULL;
+	table_insert(table, table_size, node, param->id, history);
+	table_used++;
+	return history;
+}
+
+bool pycsh_history_enabled(void) {
+	return atomic_load_explicit(&rule_count, memory_order_relaxed) > 0;
+}
+
+void pycsh_history_record(const param_t * param) {
+
+	if (param == NULL || atomic_load_explicit(&rule_count, memory_order_relaxed) == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&history_lock);
+
+	pycsh_history_t * const history = history_get(param);
+	if (history == NULL || history->type != param->type) {
+		pthread_mutex_unlock(&history_lock);
+		return;
+	}
+
+	csp_timestamp_t timestamp = {0};
+	if (param->timestamp != NULL) {
+		timestamp = *param->timestamp;
+	}
+	if (timestamp.tv_sec == 0) {
+		csp_clock_get_time(&timestamp);
+	}
+
+	const size_t capacity = history->capacity;
+	const size_t row = 2 * capacity;
+	const size_t i = history->count % capacity;
+
+	double * const timestamps = history->data;
+	timestamps[i] = timestamps[i + capacity] = timestamp.tv_sec + timestamp.tv_nsec / 1E9;
+
+	/* Ignore elements beyond those we were created with, should the parameter have been redefined. */
+	int elements = param->array_size > 0 ? param->array_size : 1;
+	if (elements > history->elements) {
+		elements = history->elements;
+	}
+	for (int e = 0; e < elements; e++) {
+		double * const values = &history->data[(e + 1) * row];
+		values[i] = values[i + capacity] = pycsh_param_get_double(param, e);
+	}
+	history->count++;
+
+	pthread_mutex_unlock(&history_lock);
+}
+
+
+typedef struct {
+	PyObject_HEAD
+	pycsh_history_t * history;
+	PyObject * parameter;
+	/* Describes `history->data` for the buffer protocol */
+	Py_ssize_t shape;
+	Py_ssize_t stride;
+} ParameterHistoryObject;
+
+static void ParameterHistory_dealloc(ParameterHistoryObject * self) {
+	history_decref(self->history);
+	Py_XDECREF(self->parameter);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+/* Exports the raw storage as a read-only 1D array of doubles, `window()` slices it. */
+static int ParameterHistory_getbuffer(ParameterHistoryObject * self, Py_buffer * view, int flags) {
+
+	if (flags & PyBUF_WRITABLE) {
+		PyErr_SetString(PyExc_BufferError, "ParameterHistory is read-only");
+		view->obj = NULL;
+		return -1;
+	}
+
+	view->obj = Py_NewRef(self);
+	view->buf = self->history->data;
+	view->len = self->shape * self->stride;
+	view->readonly = 1;
+	view->itemsize = sizeof(double);
+	view->format = (flags & PyBUF_FORMAT) ? "d" : NULL;
+	view->ndim = 1;
+	view->shape = &self->shape;
+	view->strides = &self->stride;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+	return 0;
+}
+
+static PyObject * ParameterHistory_window(ParameterHistoryObject * self, PyObject * args, PyObject * kwds) {
+
+	int index = 0;
+	double seconds = -1;
+	Py_ssize_t count = -1;
+
+	static char *kwlist[] = {"index", "seconds", "count", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|idn:window", kwlist, &index, &seconds, &count))
+		return NULL;  // TypeError is thrown
+
+	pycsh_history_t * const history = self->history;
+
+	if (index < 0) {
+		index += history->elements;
+	}
+	if (index < 0 || index >= history->elements) {
+		PyErr_SetString(PyExc_IndexError, "ParameterHistory index out of range");
+		return NULL;
+	}
+
+	const size_t capacity = history->capacity;
+
+	pthread_mutex_lock(&history_lock);
+
+	const uint64_t recorded = history->count;
+	Py_ssize_t len = recorded < capacity ? recorded : capacity;
+	if (count >= 0 && count < len) {
+		len = count;
+	}
+	const Py_ssize_t end = recorded > 0 ? (recorded - 1) % capacity + capacity + 1 : 0;
+	Py_ssize_t start = end - len;
+
+	if (seconds >= 0) {
+		csp_timestamp_t now;
+		csp_clock_get_time(&now);
+		const double oldest = now.tv_sec + now.tv_nsec / 1E9 - seconds;
+		while (start < end && history->data[start] < oldest) {
+			start++;
+		}
+	}
+
+	pthread_mutex_unlock(&history_lock);
+
+	PyObject * const raw AUTO_DECREF = PyMemoryView_FromObject((PyObject *)self);
+	if (raw == NULL) {
+		return NULL;
+	}
+
+	const Py_ssize_t row = (index + 1) * 2 * capacity;
+	PyObject * const timestamps AUTO_DECREF = PySequence_GetSlice(raw, start, end);
+	if (timestamps == NULL) {
+		return NULL;
+	}
+	PyObject * const values AUTO_DECREF = PySequence_GetSlice(raw, row + start, row + end);
+	if (values == NULL) {
+		return NULL;
+	}
+
+	return PyTuple_Pack(2, timestamps, values);
+}
+
+static Py_ssize_t ParameterHistory_length(ParameterHistoryObject * self) {
+	pthread_mutex_lock(&history_lock);
+	const uint64_t recorded = self->history->count;
+	pthread_mutex_unlock(&history_lock);
+	return recorded < self->history->capacity ? (Py_ssize_t)recorded : (Py_ssize_t)self->history->capacity;
+}
+
+static PyObject * ParameterHistory_get_capacity(ParameterHistoryObject * self, void * closure) {
+	return PyLong_FromSize_t(self->history->capacity);
+}
+
+static PyObject * ParameterHistory_get_recorded(ParameterHistoryObject * self, void * closure) {
+	pthread_mutex_lock(&history_lock);
+	const uint64_t recorded = self->history->count;
+	pthread_mutex_unlock(&history_lock);
+	return PyLong_FromUnsignedLongLong(recorded);
+}
+
+static PyObject * ParameterHistory_get_parameter(ParameterHistoryObject * self, void * closure) {
+	return Py_NewRef(self->parameter);
+}
+
+static PyObject * ParameterHistory_repr(ParameterHistoryObject * self) {
+	return PyUnicode_FromFormat("<%s of %s, %zd/%zu samples>", Py_TYPE(self)->tp_name,
+		self->history->name, ParameterHistory_length(self), self->history->capacity);
+}
+
+PyObject * pycsh_history(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	PyObject * param_identifier;
+	int node = pycsh_dfl_node;
+
+	static char *kwlist[] = {"param_identifier", "node", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:history", kwlist, &param_identifier, &node))
+		return NULL;  // TypeError is thrown
+
+	const param_t * const param = _pycsh_util_find_param_t(param_identifier, node);
+	if (param == NULL) {
+		return NULL;  // Raises TypeError or ValueError.
+	}
+
+	pthread_mutex_lock(&history_lock);
+	pycsh_history_t * const history = history_get(param);
+	if (history != NULL) {
+		atomic_fetch_add(&history->refcount, 1);
+	}
+	pthread_mutex_unlock(&history_lock);
+
+	if (history == NULL) {
+		Py_RETURN_NONE;
+	}
+
+	ParameterHistoryObject * const history_obj = (ParameterHistoryObject *)ParameterHistoryType.tp_alloc(&ParameterHistoryType, 0);
+	if (history_obj == NULL) {
+		history_decref(history);
+		return NULL;
+	}
+	history_obj->history = history;
+	history_obj->shape = (history->elements + 1) * 2 * history->capacity;
+	history_obj->stride = sizeof(double);
+
+	history_obj->parameter = PyObject_TypeCheck(param_identifier, &ParameterType) ?
+		Py_NewRef(param_identifier) : pycsh_Parameter_from_param(&ParameterType, param, NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
+	if (history_obj->parameter == NULL) {
+		Py_DECREF(history_obj);
+		return NULL;
+	}
+
+	return (PyObject *)history_obj;
+}
+
+PyObject * pycsh_history_enable(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	Py_ssize_t capacity;
+	int node = -1;
+	PyObject * mask_obj = NULL;
+	char * globstr = NULL;
+
+	static char *kwlist[] = {"capacity", "node", "mask", "globstr", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|iOz:history_enable", kwlist, &capacity, &node, &mask_obj, &globstr))
+		return NULL;  // TypeError is thrown
+
+	if (capacity < 0) {
+		PyErr_SetString(PyExc_ValueError, "capacity must be non-negative");
+		return NULL;
+	}
+
+	uint32_t mask = 0xFFFFFFFF;
+	if (mask_obj != NULL) {
+		if (pycsh_parse_param_mask(mask_obj, &mask) != 0) {
+			return NULL;  // Exception message set by pycsh_parse_param_mask()
+		}
+	}
+
+	char * const globstr_copy = globstr ? strdup(globstr) : NULL;
+	if (globstr != NULL && globstr_copy == NULL) {
+		return PyErr_NoMemory();
+	}
+
+	pthread_mutex_lock(&history_lock);
+
+	const int count = atomic_load(&rule_count);
+	history_rule_t * const new_rules = realloc(rules, (count + 1) * sizeof(*rules));
+	if (new_rules == NULL) {
+		pthread_mutex_unlock(&history_lock);
+		free(globstr_copy);
+		return PyErr_NoMemory();
+	}
+	rules = new_rules;
+
+	history_rule_t * const rule = &rules[count];
+	*rule = (history_rule_t){.node = node, .mask = mask, .globstr = globstr_copy, .capacity = capacity};
+	pycsh_glob_compile(&rule->glob, rule->globstr);
+	atomic_store(&rule_count, count + 1);
+
+	const int res = table_rebuild(table_used);
+
+	pthread_mutex_unlock(&history_lock);
+
+	if (res < 0) {
+		return PyErr_NoMemory();
+	}
+	Py_RETURN_NONE;
+}
+
+PyObject * pycsh_history_disable(PyObject * self, PyObject * args) {
+	(void)self;
+	(void)args;
+
+	pthread_mutex_lock(&history_lock);
+
+	for (int i = 0; i < atomic_load(&rule_count); i++) {
+		free(rules[i].globstr);
+	}
+	free(rules);
+	rules = NULL;
+	atomic_store(&rule_count, 0);
+
+	for (size_t i = 0; i < table_size; i++) {
+		if (table[i].used) {
+			history_decref(table[i].history);
+		}
+	}
+	free(table);
+	table = NULL;
+	table_size = 0;
+	table_used = 0;
+
+	pthread_mutex_unlock(&history_lock);
+
+	Py_RETURN_NONE;
+}
+
+static PyBufferProcs ParameterHistory_as_buffer = {
+	.bf_getbuffer = (getbufferproc)ParameterHistory_getbuffer,
+};
+
+static PySequenceMethods ParameterHistory_as_sequence = {
+	.sq_length = (lenfunc)ParameterHistory_length,
+};
+
+static PyGetSetDef ParameterHistory_getsetters[] = {
+	{"capacity", (getter)ParameterHistory_get_capacity, NULL,
+     "Maximum number of samples kept.", NULL},
+	{"recorded", (getter)ParameterHistory_get_recorded, NULL,
+     "Total number of samples recorded, including those no longer kept.", NULL},
+	{"parameter", (getter)ParameterHistory_get_parameter, NULL,
+     "The recorded parameter.", NULL},
+    {NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef ParameterHistory_methods[] = {
+	{"window", (PyCFunctionWithKeywords)ParameterHistory_window, METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR("Return (timestamps, values) of the recorded samples of the specified index, as read-only memoryviews of doubles.")},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
+PyTypeObject ParameterHistoryType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "pycsh.ParameterHistory",
+	.tp_doc = "Recently received values of a parameter, returned by pycsh.history().",
+	.tp_basicsize = sizeof(ParameterHistoryObject),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_dealloc = (destructor)ParameterHistory_dealloc,
+	.tp_repr = (reprfunc)ParameterHistory_repr,
+	.tp_as_sequence = &ParameterHistory_as_sequence,
+	.tp_as_buffer = &ParameterHistory_as_buffer,
+	.tp_methods = ParameterHistory_methods,
+	.tp_getset = ParameterHistory_getsetters,
+};
@@ -18,6 +18,11 @@
 
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
+#include <pycsh/param_index.h>
+#include <pycsh/dispatch.h>
+#include <pycsh/callback_filter.h>
+#include <pycsh/router_stats.h>
 #include <pycsh/attr_malloc.h>
 
 #include "valueproxy.h"
@@ -147,7 +152,7 @@ static PyObject * Parameter_find(PyTypeObject *type, PyObject *args, PyObject *k
 	int timeout = pycsh_dfl_timeout;
 	int retries = 1;
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Oiiii", kwlist, &param_identifier, &node, &host, &paramver, &timeout, &retries)) {
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OiiO&i", kwlist, &param_identifier, &node, &host, &paramver, pycsh_parse_timeout, &timeout, &retries)) {
 		return NULL;  // TypeError is thrown
 	}
 
@@ -308,7 +313,12 @@ static int Parameter_set_oldvalue(ParameterObject *self, PyObject *value, void *
 static PyObject * Parameter_get_valueproxy(ParameterObject *self, void *closure) {
     (void)closure;
 	/* Default to remote, user can override by calling the ValueProxy, i.e: `.value_index(remote=False)[0]` */
-	return pycsh_ValueProxy_from_Parameter(&ValueProxyType, self);
+	ValueProxyObject * const value_proxy = (ValueProxyObject*)pycsh_ValueProxy_from_Parameter(&ValueProxyType, self);
+	if (!value_proxy) {
+		return NULL;
+	}
+	ValueProxy_gather_track(value_proxy);
+	return (PyObject*)value_proxy;  /* Already new reference */
 }
 
 static PyObject * Parameter_get_valueproxy_cached(ParameterObject *self, void *closure) {
@@ -362,6 +372,9 @@ static PyObject * Parameter_is_vmem(ParameterObject *self, void *closure) {
 
 static PyObject * Parameter_get_timeout(ParameterObject *self, void *closure) {
     (void)closure;
+	if (self->timeout == PYCSH_TIMEOUT_AUTO) {
+		Py_RETURN_NONE;  /* Derived from the round-trip time of the node. */
+	}
 	return Py_BuildValue("i", self->timeout);
 }
 
@@ -374,7 +387,7 @@ static int Parameter_set_timeout(ParameterObject *self, PyObject *value, void *c
     }
 
 	if (value == Py_None) {
-		self->timeout = pycsh_dfl_timeout;
+		self->timeout = PYCSH_TIMEOUT_AUTO;
 		return 0;
 	}
 
@@ -698,6 +711,10 @@ static void Parameter_dealloc(ParameterObject *self) {
     //PyErr_Clear();
 
 	assert(self->param);
+	/* Filters are keyed by `param_t*`, so one left behind would apply to a later param_t allocated at the same address,
+		and may outlive our param_t even when it remains in the list. */
+	pycsh_callback_filter_remove(self->param);
+	pycsh_dispatch_forget(self->param);  // Same for callbacks still queued for us.
 	const param_t * const list_param = param_list_find_id(*self->param->node, self->param->id);
 	if (!self->is_const && (list_param == NULL || list_param != self->param)) {
 		/* Our parameter is not in the list, we should free it. */
@@ -729,7 +746,27 @@ static void Parameter_dealloc(ParameterObject *self) {
  * 	that must call a PyObject* callback function.
  */
 void Parameter_callback(const param_t * param, int offset) {
-    PyGILState_STATE CLEANUP_GIL gstate = PyGILState_Ensure();
+
+    /* Unchanged values shouldn't cost us the GIL. */
+    if (!pycsh_callback_filter_pass(param, offset)) {
+        return;
+    }
+
+    /* Leave the callback to the dispatcher thread, rather than stalling the router while waiting for the GIL. */
+    if (pycsh_dispatch_enqueue(param, offset)) {
+        return;
+    }
+
+    /* Includes waiting for the GIL, which is what stalls the router when callbacks are called from it. */
+    const uint64_t start_us = pycsh_stats_now_us();
+    {
+        PyGILState_STATE CLEANUP_GIL gstate = PyGILState_Ensure();
+        Parameter_callback_invoke(param, offset);
+    }
+    pycsh_router_record_callback(start_us);
+}
+
+void Parameter_callback_invoke(const param_t * param, int offset) {
     assert(Parameter_wraps_param(param));
     
     /* `Parameter_callback` may be called many times before we call the `on_python_slash_execute_post_hook()`.
@@ -762,7 +799,9 @@ void Parameter_callback(const param_t * param, int offset) {
     PyObject *pyoffset AUTO_DECREF = Py_BuildValue("i", offset);
     PyObject * args AUTO_DECREF = PyTuple_Pack(2, python_param, pyoffset);
     /* Call the user Python callback */
+    const uint64_t start_us = pycsh_stats_now_us();
     PyObject *value AUTO_DECREF = PyObject_CallObject(python_callback, args);
+    pycsh_stats_record(*param->node, PYCSH_STATS_CALLBACK, start_us, false, 0, 0);
 
     if (PyErr_Occurred()) {
         /* It may not be clear to the user, that the exception came from the callback,
@@ -890,7 +929,7 @@ static PyObject * Parameter_new(PyTypeObject *cls, PyObject * args, PyObject * k
     /* TODO Kevin: Should `host` and `node` be separate arguments. */
     static char *kwlist[] = {"id", "name", "type", "mask", "array_size", "callback", "unit", "docstr", "host", "timeout", "retries", "paramver", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "HsiO|iOzziiii", kwlist, &id, &name, &param_type, &mask_obj, &array_size, &callback, &unit, &docstr, &host, &timeout, &retries, &paramver))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "HsiO|iOzziO&ii", kwlist, &id, &name, &param_type, &mask_obj, &array_size, &callback, &unit, &docstr, &host, pycsh_parse_timeout, &timeout, &retries, &paramver))
         return NULL;  // TypeError is thrown
 
     uint32_t mask;
@@ -932,6 +971,11 @@ static PyObject * Parameter_get_callback(ParameterObject *self, void *closure) {
     return Py_NewRef(self->callback);
 }
 
+static PyObject * Parameter_get_callback_filtered(ParameterObject *self, void *closure) {
+    (void)closure;
+    return PyLong_FromUnsignedLongLong(pycsh_callback_filter_filtered(self->param));
+}
+
 static PyObject * Parameter_GetItem(ParameterObject *self, PyObject *item) {
 
 	#pragma GCC diagnostic push
@@ -1021,6 +1065,8 @@ static PyGetSetDef Parameter_getsetters[] = {
 
 	{"callback", (getter)Parameter_get_callback, (setter)Parameter_set_callback,
      "callback of the parameter", NULL},
+	{"callback_filtered", (getter)Parameter_get_callback_filtered, NULL,
+     PyDoc_STR("number of values kept from the callback by its filter"), NULL},
 
 	{"value", (getter)Parameter_get_valueproxy, (setter)Parameter_set_valueproxy,
      PyDoc_STR("get/set the remote/cached value of the parameter"), NULL},
@@ -1068,6 +1114,7 @@ static PyObject * Parameter_list_add(ParameterObject *self, PyObject *args, PyOb
 
 	/* res==1=="existing parameter updated" */
 	const int res = param_list_add(self->param);
+	pycsh_param_index_invalidate();
 
     /* `self` is now added to the list.
         Although if we updated an existing parameter,
@@ -1106,6 +1153,7 @@ static PyObject * Parameter_list_forget(ParameterObject *self, PyObject *args, P
 
 	/* `param_list_destroy()` will be called by `Parameter_dealloc()` */
 	param_list_remove_specific(self->param, verbose, false);
+	pycsh_param_index_invalidate();
 
     const param_t * const list_param_after = param_list_find_id(*self->param->node, self->param->id);
 
@@ -1117,6 +1165,31 @@ static PyObject * Parameter_list_forget(ParameterObject *self, PyObject *args, P
 	Py_RETURN_NONE;
 }
 
+static PyObject * Parameter_set_callback_filter(ParameterObject *self, PyObject *args, PyObject *kwds) {
+
+	int on_change = false;
+	double deadband = 0;
+	double rel_deadband = 0;
+	unsigned int min_interval = 0;
+
+	static char * kwlist[] = {"on_change", "deadband", "rel_deadband", "min_interval", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|pddI:set_callback_filter", kwlist, &on_change, &deadband, &rel_deadband, &min_interval)) {
+		return NULL;  // TypeError is thrown
+	}
+
+	if (deadband < 0 || rel_deadband < 0) {
+		PyErr_SetString(PyExc_ValueError, "deadband and rel_deadband must not be negative");
+		return NULL;
+	}
+
+	if (pycsh_callback_filter_set(self->param, on_change, deadband, rel_deadband, min_interval) < 0) {
+		return PyErr_NoMemory();
+	}
+
+	Py_RETURN_NONE;
+}
+
 /* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
@@ -1125,6 +1198,8 @@ static PyMethodDef Parameter_methods[] = {
 		"And allows it to be found in `pycsh.list()`")},
     {"list_forget", (PyCFunctionWithKeywords)Parameter_list_forget, METH_VARARGS | METH_KEYWORDS, PyDoc_STR("Remove this parameter from the global parameter list. Hiding it from other CSP nodes on the network. "\
 		"Also removes it from `pycsh.list()`")},
+    {"set_callback_filter", (PyCFunctionWithKeywords)Parameter_set_callback_filter, METH_VARARGS | METH_KEYWORDS, PyDoc_STR("Only call the callback for values which changed (by more than a deadband), "\
+		"or at most once per `min_interval` milliseconds. Calling it without arguments removes the filter.")},
     {NULL, NULL, 0, NULL}
 };
 #pragma GCC diagnostic pop
@@ -16,6 +16,7 @@
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
 #include <pycsh/parameter.h>
+#include <pycsh/stats.h>
 
 
 /**
@@ -37,7 +38,13 @@ PyObject * ParameterList_append(PyObject * self, PyObject * args) {
 		return NULL;
 	}
 
-	//PyList_Append(self, obj);
+	/* `super().append()` is `list.append()`, unless we have been subclassed. */
+	if (Py_IS_TYPE(self, &ParameterListType)) {
+		if (PyList_Append(self, obj) < 0) {
+			return NULL;
+		}
+		Py_RETURN_NONE;
+	}
 
 	/* 
 	Finding the name in the superclass is likely not nearly as efficient 
@@ -91,9 +98,11 @@ static PyObject * ParameterList_pull(ParameterListObject *self, PyObject *args,
 	}
 
 	int pull_res;
+	const uint64_t start_us = pycsh_stats_now_us();
 	Py_BEGIN_ALLOW_THREADS;
 		pull_res = param_pull_queue(&queue, CSP_PRIO_NORM, 0, node, timeout);
 	Py_END_ALLOW_THREADS;
+	pycsh_stats_record(node, PYCSH_STATS_PULL, start_us, pull_res != 0, queue.used, 0);
 	if (pull_res) {
 		PyErr_Format(PyExc_ConnectionError, "No response (node=%d, timeout=%d)", node, timeout);
 		return 0;
@@ -147,9 +156,11 @@ static PyObject * ParameterList_push(ParameterListObject *self, PyObject *args,
 	}
 
 	int push_res;
+	const uint64_t start_us = pycsh_stats_now_us();
 	Py_BEGIN_ALLOW_THREADS;
 		push_res = param_push_queue(&queue, 1, 0, node, timeout, hwid, false);
 	Py_END_ALLOW_THREADS;
+	pycsh_stats_record(node, PYCSH_STATS_PUSH, start_us, push_res < 0, queue.used, 0);
 
 	if (push_res < 0) {
 		PyErr_Format(PyExc_ConnectionError, "No response (node=%d, timeout=%d)", node, timeout);
@@ -0,0 +1,332 @@
+/*
+ * parameterlistview.c
+ *
+ * Contains the ParameterListView class.
+ * A read-only sequence of parameters, which only creates Parameter wrappers for the elements actually accessed.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include "parameterlistview.h"
+
+#include <stdlib.h>
+
+#include <param/param_list.h>
+
+#include <pycsh/pycsh.h>
+#include <pycsh/utils.h>
+#include <pycsh/parameter.h>
+#include <pycsh/param_index.h>
+
+#include "parameterlist.h"
+
+
+static bool param_matches(const param_t * param, uint32_t mask, int node, const pycsh_glob_t * glob) {
+	if ((node >= 0) && (*param->node != node)) {
+		return false;
+	}
+	if ((param->mask & mask) == 0) {
+		return false;
+	}
+	return pycsh_glob_match(glob, param->name);
+}
+
+/* Takes ownership of `params`, which must be allocated by `PyMem_Malloc()`. */
+static PyObject * ParameterListView_new_from_array(const param_t ** params, Py_ssize_t count, uint64_t generation) {
+
+	ParameterListViewObject * self = (ParameterListViewObject *)ParameterListViewType.tp_alloc(&ParameterListViewType, 0);
+	if (self == NULL) {
+		PyMem_Free(params);
+		return NULL;
+	}
+
+	self->params = params;
+	self->count = count;
+	self->generation = generation;
+	return (PyObject *)self;
+}
+
+PyObject * ParameterListView_from_list(uint32_t mask, int node, const char * globstr) {
+
+	pycsh_glob_t glob;
+	pycsh_glob_compile(&glob, globstr);
+
+	Py_ssize_t count = 0;
+	const param_t * param;
+	param_list_iterator i = {0};
+	while ((param = param_list_iterate(&i)) != NULL) {
+		if (param_matches(param, mask, node, &glob)) {
+			count++;
+		}
+	}
+
+	/* Allocate at least 1 element, so NULL always means out of memory. */
+	const param_t ** const params = PyMem_Malloc((count > 0 ? count : 1) * sizeof(*params));
+	if (params == NULL) {
+		return PyErr_NoMemory();
+	}
+
+	Py_ssize_t filled = 0;
+	i = (param_list_iterator){0};
+	while ((param = param_list_iterate(&i)) != NULL && filled < count) {
+		if (param_matches(param, mask, node, &glob)) {
+			params[filled++] = param;
+		}
+	}
+
+	return ParameterListView_new_from_array(params, filled, pycsh_param_index_generation());
+}
+
+static int compare_ptr(const void * a, const void * b) {
+	const uintptr_t pa = (uintptr_t)*(const param_t * const *)a;
+	const uintptr_t pb = (uintptr_t)*(const param_t * const *)b;
+	return (pa > pb) - (pa < pb);
+}
+
+/**
+ * @brief Check that our `param_t`s have not been destroyed since we last looked.
+ *
+ * Only compares pointers against the parameter list, as dereferencing them may no longer be safe.
+ *
+ * @return 0 when all `param_t`s are still in the list, otherwise -1 with RuntimeError set.
+ */
+static int ParameterListView_check_alive(ParameterListViewObject * self) {
+
+	const uint64_t generation = pycsh_param_index_generation();
+	if (self->generation == generation) {
+		return 0;
+	}
+
+	Py_ssize_t list_count = 0;
+	param_list_iterator i = {0};
+	while (param_list_iterate(&i) != NULL) {
+		list_count++;
+	}
+
+	const param_t ** const live = PyMem_Malloc((list_count > 0 ? list_count : 1) * sizeof(*live));
+	if (live == NULL) {
+		PyErr_NoMemory();
+		return -1;
+	}
+
+	const param_t * param;
+	Py_ssize_t filled = 0;
+	i = (param_list_iterator){0};
+	while ((param = param_list_iterate(&i)) != NULL && filled < list_count) {
+		live[filled++] = param;
+	}
+	qsort(live, filled, sizeof(*live), compare_ptr);
+
+	bool alive = true;
+	for (Py_ssize_t j = 0; j < self->count && alive; j++) {
+		alive = bsearch(&self->params[j], live, filled, sizeof(*live), compare_ptr) != NULL;
+	}
+	PyMem_Free(live);
+
+	if (!alive) {
+		PyErr_SetString(PyExc_RuntimeError, "Parameters in this view have been removed from the parameter list");
+		return -1;
+	}
+
+	self->generation = generation;
+	return 0;
+}
+
+static void ParameterListView_dealloc(ParameterListViewObject * self) {
+	PyMem_Free(self->params);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static Py_ssize_t ParameterListView_length(ParameterListViewObject * self) {
+	return self->count;
+}
+
+static PyObject * ParameterListView_item(ParameterListViewObject * self, Py_ssize_t index) {
+
+	if (index < 0 || index >= self->count) {
+		PyErr_SetString(PyExc_IndexError, "ParameterListView index out of range");
+		return NULL;
+	}
+
+	if (ParameterListView_check_alive(self) < 0) {
+		return NULL;
+	}
+
+	/* CSH does not specify a paramver when listing parameters,
+		so we just use 2 as the default version for the created instances. */
+	return pycsh_Parameter_from_param(&ParameterType, self->params[index], NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
+}
+
+static PyObject * ParameterListView_subscript(ParameterListViewObject * self, PyObject * key) {
+
+	if (PyIndex_Check(key)) {
+		Py_ssize_t index = PyNumber_AsSsize_t(key, PyExc_IndexError);
+		if (index == -1 && PyErr_Occurred()) {
+			return NULL;
+		}
+		if (index < 0) {
+			index += self->count;
+		}
+		return ParameterListView_item(self, index);
+	}
+
+	if (!PySlice_Check(key)) {
+		PyErr_Format(PyExc_TypeError, "ParameterListView indices must be integers or slices, not %s", Py_TYPE(key)->tp_name);
+		return NULL;
+	}
+
+	Py_ssize_t start, stop, step;
+	if (PySlice_Unpack(key, &start, &stop, &step) < 0) {
+		return NULL;
+	}
+	const Py_ssize_t slice_len = PySlice_AdjustIndices(self->count, &start, &stop, step);
+
+	const param_t ** const params = PyMem_Malloc((slice_len > 0 ? slice_len : 1) * sizeof(*params));
+	if (params == NULL) {
+		return PyErr_NoMemory();
+	}
+	for (Py_ssize_t i = 0, j = start; i < slice_len; i++, j += step) {
+		params[i] = self->params[j];
+	}
+
+	/* The slice can't be any more alive than we are. */
+	return ParameterListView_new_from_array(params, slice_len, self->generation);
+}
+
+static PyObject * ParameterListView_filter(ParameterListViewObject * self, PyObject * args, PyObject * kwds) {
+
+	int node = -1;
+	PyObject * mask_obj = NULL;
+	char * globstr = NULL;
+
+	static char *kwlist[] = {"node", "mask", "globstr", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iOz:filter", kwlist, &node, &mask_obj, &globstr))
+		return NULL;  // TypeError is thrown
+
+	uint32_t mask = 0xFFFFFFFF;
+	if (mask_obj != NULL) {
+		if (pycsh_parse_param_mask(mask_obj, &mask) != 0) {
+			return NULL;  // Exception message set by pycsh_parse_param_mask()
+		}
+	}
+
+	/* We are about to read `node`, `mask` and `name` of every `param_t`. */
+	if (ParameterListView_check_alive(self) < 0) {
+		return NULL;
+	}
+
+	pycsh_glob_t glob;
+	pycsh_glob_compile(&glob, globstr);
+
+	const param_t ** const params = PyMem_Malloc((self->count > 0 ? self->count : 1) * sizeof(*params));
+	if (params == NULL) {
+		return PyErr_NoMemory();
+	}
+
+	Py_ssize_t count = 0;
+	for (Py_ssize_t i = 0; i < self->count; i++) {
+		if (param_matches(self->params[i], mask, node, &glob)) {
+			params[count++] = self->params[i];
+		}
+	}
+
+	return ParameterListView_new_from_array(params, count, self->generation);
+}
+
+static PyObject * ParameterListView_to_list(ParameterListViewObject * self, PyObject * Py_UNUSED(ignored)) {
+
+	PyObject * items AUTO_DECREF = PyList_New(self->count);
+	if (items == NULL) {
+		return NULL;
+	}
+
+	for (Py_ssize_t i = 0; i < self->count; i++) {
+		PyObject * parameter = ParameterListView_item(self, i);
+		if (parameter == NULL) {
+			return NULL;
+		}
+		PyList_SET_ITEM(items, i, parameter);  // Steals reference
+	}
+
+	PyObject * list AUTO_DECREF = PyObject_CallObject((PyObject *)&ParameterListType, NULL);
+	if (list == NULL) {
+		return NULL;
+	}
+	if (PyList_SetSlice(list, 0, 0, items) < 0) {
+		return NULL;
+	}
+
+	return Py_NewRef(list);
+}
+
+static PyObject * ParameterListView_names(ParameterListViewObject * self, void * closure) {
+
+	if (ParameterListView_check_alive(self) < 0) {
+		return NULL;
+	}
+
+	PyObject * names = PyTuple_New(self->count);
+	if (names == NULL) {
+		return NULL;
+	}
+	for (Py_ssize_t i = 0; i < self->count; i++) {
+		PyObject * name = PyUnicode_FromString(self->params[i]->name);
+		if (name == NULL) {
+			Py_DECREF(names);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(names, i, name);
+	}
+	return names;
+}
+
+static PyObject * ParameterListView_repr(ParameterListViewObject * self) {
+	return PyUnicode_FromFormat("<%s of %zd parameters>", Py_TYPE(self)->tp_name, self->count);
+}
+
+static PySequenceMethods ParameterListView_as_sequence = {
+	.sq_length = (lenfunc)ParameterListView_length,
+	.sq_item = (ssizeargfunc)ParameterListView_item,
+};
+
+static PyMappingMethods ParameterListView_as_mapping = {
+	.mp_length = (lenfunc)ParameterListView_length,
+	.mp_subscript = (binaryfunc)ParameterListView_subscript,
+};
+
+static PyGetSetDef ParameterListView_getsetters[] = {
+	{"names", (getter)ParameterListView_names, NULL,
+     "Names of the parameters in the view, without creating Parameter wrappers.", NULL},
+    {NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef ParameterListView_methods[] = {
+	{"filter", (PyCFunctionWithKeywords)ParameterListView_filter, METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR("Return a new view of the parameters matching node, mask and globstr.")},
+	{"to_list", (PyCFunction)ParameterListView_to_list, METH_NOARGS,
+     PyDoc_STR("Create Parameter wrappers for every parameter in the view, and return them as a ParameterList.")},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
+/* Read-only sequence of parameters, backed by an array of `param_t` pointers.
+   Parameter wrappers are created on element access, rather than for every parameter in the list. */
+PyTypeObject ParameterListViewType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "pycsh.ParameterListView",
+	.tp_doc = "Lazy, read-only view of parameters in the global list.",
+	.tp_basicsize = sizeof(ParameterListViewObject),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_SEQUENCE,
+	.tp_dealloc = (destructor)ParameterListView_dealloc,
+	.tp_repr = (reprfunc)ParameterListView_repr,
+	.tp_as_sequence = &ParameterListView_as_sequence,
+	.tp_as_mapping = &ParameterListView_as_mapping,
+	.tp_methods = ParameterListView_methods,
+	.tp_getset = ParameterListView_getsetters,
+};
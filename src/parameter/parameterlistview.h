@@ -0,0 +1,34 @@
+/*
+ * parameterlistview.h
+ *
+ * Contains the ParameterListView class.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#pragma once
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdint.h>
+#include <param/param.h>
+
+typedef struct {
+	PyObject_HEAD
+	const param_t ** params;
+	Py_ssize_t count;
+	/* `pycsh_param_index_generation()` when `params` were last known to be in the parameter list. */
+	uint64_t generation;
+} ParameterListViewObject;
+
+extern PyTypeObject ParameterListViewType;
+
+/**
+ * @brief Create a ParameterListView of the parameters that would be returned by `pycsh_util_parameter_list()`,
+ * without creating any Parameter wrappers.
+ *
+ * @return New reference, or NULL with an exception set.
+ */
+PyObject * ParameterListView_from_list(uint32_t mask, int node, const char * globstr);
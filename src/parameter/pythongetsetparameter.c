@@ -18,6 +18,7 @@
 
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
 #include <pycsh/attr_malloc.h>
 
 #include "pycshconfig.h"
@@ -179,12 +180,89 @@ static int _pycsh_param_pyval_to_cval(param_type_e type, PyObject * value_in, vo
     return 0;
 }
 
+/* Where element `offset` is cached, and how many bytes of it we may copy. */
+static void * getter_cache_slot(PythonGetSetParameterObject *python_param, int offset, uint32_t * len) {
+    const param_t *param = python_param->parameter_object.param;
+    const uint64_t start = (uint64_t)offset*param->array_step;
+    if (offset < 0 || offset >= param->array_size || start >= python_param->vmem_heap.size) {
+        return NULL;
+    }
+    if (*len > python_param->vmem_heap.size - start) {
+        *len = python_param->vmem_heap.size - start;
+    }
+    return (char*)param->addr + start;
+}
+
+/**
+ * @brief Copy a cached getter result to `dataout`, if it is still fresh. Does not require the GIL.
+ *
+ * @return true when `dataout` was filled from the cache.
+ */
+static bool getter_cache_lookup(PythonGetSetParameterObject *python_param, int offset, void * dataout, uint32_t len) {
+
+    bool hit = false;
+    pthread_mutex_lock(&python_param->cache_lock);
+
+    if (python_param->cache_period_ms >= 0 && offset >= 0 && offset < python_param->parameter_object.param->array_size) {
+        const uint64_t stamp_us = python_param->cache_stamps_us[offset];
+        const uint64_t now_us = pycsh_stats_now_us();
+        if (stamp_us != 0 && (python_param->cache_period_ms == 0 || now_us - stamp_us < (uint64_t)python_param->cache_period_ms*1000)) {
+            uint32_t copy_len = len;
+            const void * const slot = getter_cache_slot(python_param, offset, &copy_len);
+            if (slot != NULL && copy_len == len) {
+                memcpy(dataout, slot, len);
+                hit = true;
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&python_param->cache_lock);
+    return hit;
+}
+
+static void getter_cache_store(PythonGetSetParameterObject *python_param, int offset, const void * datain, uint32_t len) {
+
+    pthread_mutex_lock(&python_param->cache_lock);
+
+    if (python_param->cache_period_ms >= 0) {
+        void * const slot = getter_cache_slot(python_param, offset, &len);
+        if (slot != NULL) {
+            memcpy(slot, datain, len);
+            python_param->cache_stamps_us[offset] = pycsh_stats_now_us();
+        }
+    }
+
+    pthread_mutex_unlock(&python_param->cache_lock);
+}
+
+/* Invalidate the cached value of element `offset`, or of all elements when `offset` is -1. */
+static void getter_cache_invalidate(PythonGetSetParameterObject *python_param, int offset) {
+
+    const int array_size = python_param->parameter_object.param->array_size;
+
+    pthread_mutex_lock(&python_param->cache_lock);
+    for (int i = 0; i < array_size; i++) {
+        if (offset < 0 || i == offset) {
+            python_param->cache_stamps_us[i] = 0;
+        }
+    }
+    pthread_mutex_unlock(&python_param->cache_lock);
+}
+
 #include <stdio.h>
 /**
  * @brief Shared getter for all param_t's wrapped by a Parameter instance.
  */
 void Parameter_getter(const vmem_t * vmem, uint64_t addr, void * dataout, uint32_t len) {
-    (void)len;
+
+    /* Serve cached values without waiting for the GIL,
+        which would otherwise serialize pull-all requests against all our Python getters. */
+    {
+        PythonGetSetParameterObject *python_param = python_wraps_vmem(vmem);
+        if (python_param != NULL && getter_cache_lookup(python_param, addr/python_param->parameter_object.param->array_step, dataout, len)) {
+            return;
+        }
+    }
 
     PyGILState_STATE CLEANUP_GIL gstate = PyGILState_Ensure();
 
@@ -223,7 +301,9 @@ void Parameter_getter(const vmem_t * vmem, uint64_t addr, void * dataout, uint32
     /* Call the user Python getter */
     PyObject *value AUTO_DECREF = PyObject_CallObject(python_getter, args);
 
-    _pycsh_param_pyval_to_cval(param->type, value, dataout, param->array_size-offset);
+    if (_pycsh_param_pyval_to_cval(param->type, value, dataout, param->array_size-offset) == 0) {
+        getter_cache_store(python_param, offset, dataout, len);
+    }
 
 #if PYCSH_HAVE_APM  // TODO Kevin: This is pretty ugly, but we can't let the error propagate when building for APM, as there is no one but us to catch it.
     if (PyErr_Occurred()) {
@@ -279,7 +359,10 @@ void Parameter_setter(const vmem_t * vmem, uint64_t addr, const void * datain, u
     }
     PyObject * args AUTO_DECREF = PyTuple_Pack(3, python_param, pyoffset, pyval);
     /* Call the user Python callback */
-    PyObject_CallObject(python_setter, args);
+    PyObject *result AUTO_DECREF = PyObject_CallObject(python_setter, args);
+
+    /* The setter may store something other than what we gave it, so ask the getter next time. */
+    getter_cache_invalidate(python_param, offset);
 
 #if 0  // TODO Kevin: Either propagate exception naturally, or set FromCause to custom getter exception.
     if (PyErr_Occurred()) {
@@ -462,8 +545,47 @@ static bool is_valid_setter(const PyObject *setter, bool raise_exc) {
     return true;
 }
 
+/* None disables the cache (-1), otherwise milliseconds to cache getter results for. */
+static int parse_cache_period(PyObject *obj, int *cache_period_ms) {
+
+    if (obj == Py_None) {
+        *cache_period_ms = -1;
+        return 0;
+    }
+
+    const long period = PyLong_AsLong(obj);
+    if (period == -1 && PyErr_Occurred()) {
+        return -1;  // TypeError is thrown
+    }
+    if (period < 0 || period > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "cache_period must be None or a non-negative number of milliseconds");
+        return -1;
+    }
+
+    *cache_period_ms = (int)period;
+    return 0;
+}
+
 static void PythonGetSetParameter_dealloc(PythonGetSetParameterObject *self) {
 
+    /* `cache_stamps_us` is the last field initialized by `PythonGetSetParameter_new()`. */
+    if (self->cache_stamps_us != NULL) {
+        /* `Parameter_getter()` reads the cache without the GIL, and our param_t may outlive us in the list.
+            So point it back at its own memory, and wait out any lookup already holding the lock, before tearing down the cache. */
+        pthread_mutex_lock(&self->cache_lock);
+        param_t * const param = self->parameter_object.param;
+        if (param != NULL && param->vmem == &self->vmem_heap) {
+            param->vmem = NULL;
+        }
+        self->vmem_heap.read = NULL;
+        self->cache_period_ms = -1;
+        pthread_mutex_unlock(&self->cache_lock);
+
+        free(self->cache_stamps_us);
+        self->cache_stamps_us = NULL;
+        pthread_mutex_destroy(&self->cache_lock);
+    }
+
     if (self->getter_func != NULL && self->getter_func != Py_None) {
         Py_XDECREF(self->getter_func);
         self->getter_func = NULL;
@@ -597,12 +719,18 @@ static PyObject * PythonGetSetParameter_new(PyTypeObject *type, PyObject * args,
     int paramver = 2;
     PyObject *getter_func = NULL;
     PyObject *setter_func = NULL;
+    PyObject *cache_period_obj = Py_None;
 
-    static char *kwlist[] = {"id", "name", "type", "mask", "unit", "docstr", "array_size", "callback", "host", "timeout", "retries", "paramver", "getter", "setter", NULL};
+    static char *kwlist[] = {"id", "name", "type", "mask", "unit", "docstr", "array_size", "callback", "host", "timeout", "retries", "paramver", "getter", "setter", "cache_period", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "HsiO|zziOiiiiOO", kwlist, &id, &name, &param_type, &mask_obj, &unit, &docstr, &array_size, &callback, &host, &timeout, &retries, &paramver, &getter_func, &setter_func))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "HsiO|zziOiiiiOOO", kwlist, &id, &name, &param_type, &mask_obj, &unit, &docstr, &array_size, &callback, &host, &timeout, &retries, &paramver, &getter_func, &setter_func, &cache_period_obj))
         return NULL;  // TypeError is thrown
 
+    int cache_period_ms;
+    if (parse_cache_period(cache_period_obj, &cache_period_ms) < 0) {
+        return NULL;
+    }
+
     if (getter_func == NULL && setter_func == NULL) {
         PyErr_SetString(PyExc_TypeError, "PythonGetSetParameter must have at least a getter or setter (for technical reasons)");
         return NULL;
@@ -653,6 +781,14 @@ static PyObject * PythonGetSetParameter_new(PyTypeObject *type, PyObject * args,
             self->vmem_heap.write = Parameter_setter;
         }
         assert(self->vmem_heap.read != NULL || self->vmem_heap.write != NULL);
+
+        self->cache_period_ms = cache_period_ms;
+        self->cache_stamps_us = calloc(array_size, sizeof(*self->cache_stamps_us));
+        if (self->cache_stamps_us == NULL) {
+            Py_DECREF(self);
+            return PyErr_NoMemory();
+        }
+        pthread_mutex_init(&self->cache_lock, NULL);
     }
     // Point our parameter to use our newly initialized get/set VMEM
     self->parameter_object.param->vmem = &self->vmem_heap;
@@ -662,11 +798,81 @@ static PyObject * PythonGetSetParameter_new(PyTypeObject *type, PyObject * args,
 }
 
 
+static PyObject * Parameter_get_cache_period(PythonGetSetParameterObject *self, void *closure) {
+    (void)closure;
+    if (self->cache_period_ms < 0) {
+        Py_RETURN_NONE;
+    }
+    return Py_BuildValue("i", self->cache_period_ms);
+}
+
+static int Parameter_set_cache_period(PythonGetSetParameterObject *self, PyObject *value, void *closure) {
+    (void)closure;
+
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete the cache_period attribute");
+        return -1;
+    }
+
+    int cache_period_ms;
+    if (parse_cache_period(value, &cache_period_ms) < 0) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&self->cache_lock);
+    self->cache_period_ms = cache_period_ms;
+    pthread_mutex_unlock(&self->cache_lock);
+    /* Values cached with the old period shouldn't outlive the new one. */
+    getter_cache_invalidate(self, -1);
+    return 0;
+}
+
+static PyObject * PythonGetSetParameter_invalidate(PythonGetSetParameterObject *self, PyObject *args, PyObject *kwds) {
+
+    PyObject *offset_obj = Py_None;
+
+    static char *kwlist[] = {"offset", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:invalidate", kwlist, &offset_obj))
+        return NULL;  // TypeError is thrown
+
+    int offset = -1;
+    if (offset_obj != Py_None) {
+        offset = PyLong_AsLong(offset_obj);
+        if (offset == -1 && PyErr_Occurred()) {
+            return NULL;  // TypeError is thrown
+        }
+        if (offset < 0) {
+            offset += self->parameter_object.param->array_size;  // Python style negative index
+        }
+    }
+
+    if (offset_obj != Py_None && (offset < 0 || offset >= self->parameter_object.param->array_size)) {
+        PyErr_Format(PyExc_IndexError, "Offset %d out of range for parameter of size %d", offset, self->parameter_object.param->array_size);
+        return NULL;
+    }
+
+    getter_cache_invalidate(self, offset);
+    Py_RETURN_NONE;
+}
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef PythonGetSetParameter_methods[] = {
+    {"invalidate", (PyCFunctionWithKeywords)PythonGetSetParameter_invalidate, METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR("Discard the cached getter result of `offset`, or of all indexes when not specified. The getter will be called for the next read.")},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
 static PyGetSetDef PythonParameter_getsetters[] = {
     {"getter", (getter)Parameter_get_getter, (setter)Parameter_set_getter,
      "getter of the parameter", NULL},
     {"setter", (getter)Parameter_get_setter, (setter)Parameter_set_setter,
      "setter of the parameter", NULL},
+    {"cache_period", (getter)Parameter_get_cache_period, (setter)Parameter_set_cache_period,
+     "milliseconds to cache getter results for, 0 caches until invalidated, None disables the cache", NULL},
     {NULL, NULL, NULL, NULL, NULL}  /* Sentinel */
 };
 
@@ -680,6 +886,7 @@ PyTypeObject PythonGetSetParameterType = {
     .tp_new = PythonGetSetParameter_new,
     .tp_dealloc = (destructor)PythonGetSetParameter_dealloc,
     .tp_getset = PythonParameter_getsetters,
+    .tp_methods = PythonGetSetParameter_methods,
     // .tp_str = (reprfunc)Parameter_str,
     // .tp_richcompare = (richcmpfunc)Parameter_richcompare,
     .tp_base = &ParameterType,
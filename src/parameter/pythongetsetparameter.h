@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <pthread.h>
+
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
@@ -37,6 +39,12 @@ typedef struct {
         It would be nice to reuse it,
         but it probably can't help us find our PythonGetSetParameterObject */
     vmem_t vmem_heap;  
+
+    /* Opt-in cache of getter results, stored in the buffer of ->param->addr (which our vmem otherwise leaves unused).
+        Allows `Parameter_getter()` to answer remote pulls without the GIL. */
+    int cache_period_ms;  // <0 disables the cache, 0 keeps cached values until invalidated.
+    uint64_t *cache_stamps_us;  // When each element was last fetched from the getter, 0 when invalid.
+    pthread_mutex_t cache_lock;  // Protects the fields above, and the cached values, as the router doesn't hold the GIL.
 } PythonGetSetParameterObject;
 
 extern PyTypeObject PythonGetSetParameterType;
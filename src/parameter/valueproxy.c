@@ -4,9 +4,166 @@
 #include "structmember.h"
 
 #include <param/param.h>
+#include <param/param_queue.h>
+#include <param/param_server.h>
 
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
+
+/* Remember how old `self->value` was when we got it, for `ValueProxy.age`. */
+static void ValueProxy_stamp_value(ValueProxyObject *self) {
+    self->value_age_ms = pycsh_param_age_ms(self->param);
+    self->value_cached_us = pycsh_stats_now_us();
+}
+
+/* Proxies created by `Parameter.value` inside a `pycsh.gather_scope()`, which have not been pulled yet.
+    Thread-local, so every thread may have its own scope, and free-threaded builds need no lock. */
+static _Thread_local PyObject * gather_pending = NULL;
+static _Thread_local int gather_depth = 0;
+
+static bool ValueProxy_needs_pull(ValueProxyObject *self) {
+    return !self->value && !self->prefetched && self->remote && *self->param->node != 0
+        && !pycsh_param_is_fresh(self->param, self->host, pycsh_dfl_max_age);
+}
+
+static int ValueProxy_dest(ValueProxyObject *self) {
+    return (self->host != INT_MIN) ? self->host : *self->param->node;
+}
+
+/* Whether `a` and `b` may be pulled by the same request, with the same options. */
+static bool ValueProxy_same_pull(ValueProxyObject *a, ValueProxyObject *b) {
+    return ValueProxy_dest(a) == ValueProxy_dest(b) && a->paramver == b->paramver
+        && a->timeout == b->timeout && a->retries == b->retries;
+}
+
+/**
+ * @brief Pull the parameters of `proxies` into the local cache, with as few requests as possible per destination.
+ * Proxies are grouped by destination and `paramver`, `timeout` and `retries`, so each is pulled as it would be on its own.
+ *
+ * Proxies whose destination did not reply are left as they were,
+ * so they pull on their own (and raise ConnectionError) when evaluated.
+ *
+ * @return 0 on success, -1 with an exception set.
+ */
+static int ValueProxy_prefetch(ValueProxyObject **proxies, Py_ssize_t count) {
+
+    if (count <= 0) {
+        return 0;
+    }
+
+    bool * const done = PyMem_Calloc(count, sizeof(*done));
+    const param_t ** const chunk_params = PyMem_Malloc(count * sizeof(*chunk_params));
+    ValueProxyObject ** const chunk_proxies = PyMem_Malloc(count * sizeof(*chunk_proxies));
+    if (done == NULL || chunk_params == NULL || chunk_proxies == NULL) {
+        PyMem_Free(done);
+        PyMem_Free(chunk_params);
+        PyMem_Free(chunk_proxies);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        done[i] = !ValueProxy_needs_pull(proxies[i]);
+    }
+
+    uint8_t queuebuffer[PARAM_SERVER_MTU] = {0};
+    param_queue_t queue;
+
+    for (Py_ssize_t first = 0; first < count; first++) {
+
+        if (done[first]) {
+            continue;
+        }
+        const int dest = ValueProxy_dest(proxies[first]);
+        const int timeout = proxies[first]->timeout;
+        const int retries = proxies[first]->retries;
+        const int paramver = proxies[first]->paramver;
+
+        param_queue_init(&queue, queuebuffer, PARAM_SERVER_MTU - 2, 0, PARAM_QUEUE_TYPE_GET, paramver);
+        size_t chunk_cnt = 0;
+
+        for (Py_ssize_t i = first; i <= count; i++) {
+
+            ValueProxyObject * const proxy = (i < count) ? proxies[i] : NULL;
+            if (proxy != NULL && (done[i] || !ValueProxy_same_pull(proxy, proxies[first]))) {
+                continue;
+            }
+
+            /* Pull the chunk when the next parameter does not fit, or when there are no more for this destination. */
+            if (proxy == NULL || param_queue_add(&queue, proxy->param, -1, NULL) < 0) {
+
+                if (chunk_cnt > 0) {
+                    int res = -1;
+                    Py_BEGIN_ALLOW_THREADS;
+                    for (int r = 0; r < (retries > 0 ? retries : 1); r++) {
+                        res = pycsh_param_pull_queue_params(&queue, chunk_params, chunk_cnt, 1, dest, pycsh_stats_resolve_timeout(timeout, dest, r, pycsh_dfl_timeout));
+                        if (res >= 0) {
+                            break;
+                        }
+                        if (r < retries-1) {
+                            pycsh_stats_retry(dest, PYCSH_STATS_PULL);
+                        }
+                    }
+                    Py_END_ALLOW_THREADS;
+                    for (size_t j = 0; j < chunk_cnt && res >= 0; j++) {
+                        chunk_proxies[j]->prefetched = true;
+                    }
+                }
+
+                if (proxy == NULL) {
+                    break;
+                }
+
+                param_queue_init(&queue, queuebuffer, PARAM_SERVER_MTU - 2, 0, PARAM_QUEUE_TYPE_GET, paramver);
+                chunk_cnt = 0;
+                if (param_queue_add(&queue, proxy->param, -1, NULL) < 0) {
+                    done[i] = true;  // Left to pull on its own.
+                    continue;
+                }
+            }
+
+            done[i] = true;
+            chunk_params[chunk_cnt] = proxy->param;
+            chunk_proxies[chunk_cnt] = proxy;
+            chunk_cnt++;
+        }
+    }
+
+    PyMem_Free(done);
+    PyMem_Free(chunk_params);
+    PyMem_Free(chunk_proxies);
+    return 0;
+}
+
+/* Pull everything tracked by the active `pycsh.gather_scope()`, and stop tracking it. */
+static int ValueProxy_prefetch_pending(void) {
+
+    if (gather_pending == NULL || PyList_GET_SIZE(gather_pending) == 0) {
+        return 0;
+    }
+
+    PyObject * const pending AUTO_DECREF = gather_pending;
+    gather_pending = PyList_New(0);
+    if (gather_pending == NULL) {
+        gather_pending = Py_NewRef(pending);
+        return -1;
+    }
+
+    return ValueProxy_prefetch((ValueProxyObject **)PySequence_Fast_ITEMS(pending), PyList_GET_SIZE(pending));
+}
+
+void ValueProxy_gather_track(ValueProxyObject *self) {
+
+    if (gather_depth <= 0 || !ValueProxy_needs_pull(self)) {
+        return;
+    }
+
+    /* Tracking is an optimization, so failing to do so is not an error. */
+    if (PyList_Append(gather_pending, (PyObject *)self) < 0) {
+        PyErr_Clear();
+    }
+}
 
 /**
  * @brief 
@@ -23,6 +180,13 @@ static PyObject * ValueProxy_eval_value(ValueProxyObject *self, PyObject* indexe
         return self->value;
     }
 
+    /* Pull the rest of the `pycsh.gather_scope()` along with us. */
+    if (!self->prefetched && ValueProxy_prefetch_pending() < 0) {
+        return NULL;
+    }
+    const bool remote = self->remote && !self->prefetched;
+    self->prefetched = false;  // Only spares the pull of this evaluation.
+
 
     /* Explicit `None` returns whole array when `self->array`, otherwise index 0 */
     PyObject * _default_key AUTO_DECREF = NULL;
@@ -49,7 +213,8 @@ static PyObject * ValueProxy_eval_value(ValueProxyObject *self, PyObject* indexe
         //	return NULL;
         //}
 
-        self->value = _pycsh_util_get_single(self->param, idx_raw, self->remote, self->host, self->timeout, self->retries, self->paramver, self->verbose);
+        self->value = _pycsh_util_get_single(self->param, idx_raw, remote, self->host, self->timeout, self->retries, self->paramver, self->verbose);
+        ValueProxy_stamp_value(self);
         return self->value;
     }
 
@@ -60,7 +225,8 @@ static PyObject * ValueProxy_eval_value(ValueProxyObject *self, PyObject* indexe
 
     // Handle slicing
     if (PySlice_Check(indexes) || _iter) {
-        self->value = _pycsh_util_get_array_indexes(self->param, indexes, self->remote, self->host, self->timeout, self->retries, self->paramver, self->verbose);
+        self->value = _pycsh_util_get_array_indexes(self->param, indexes, remote, self->host, self->timeout, self->retries, self->paramver, self->verbose);
+        ValueProxy_stamp_value(self);
         return self->value;
     }
 
@@ -193,6 +359,9 @@ static int ValueProxy_set_host(ValueProxyObject *self, PyObject *value, void *cl
 
 static PyObject * ValueProxy_get_timeout(ValueProxyObject *self, void *closure) {
     (void)closure;
+    if (self->timeout == PYCSH_TIMEOUT_AUTO) {
+        Py_RETURN_NONE;  /* Derived from the round-trip time of the node. */
+    }
     return Py_BuildValue("i", self->timeout);
 }
 
@@ -205,7 +374,7 @@ static int ValueProxy_set_timeout(ValueProxyObject *self, PyObject *value, void
     }
 
     if (value == Py_None) {
-        self->timeout = pycsh_dfl_timeout;
+        self->timeout = PYCSH_TIMEOUT_AUTO;
         return 0;
     }
 
@@ -331,6 +500,18 @@ static PyMappingMethods ValueProxy_as_mapping = {
 The Python binding 'Parameter' class exposes most of its attributes through getters, 
 as only its 'value', 'host' and 'node' are mutable, and even those are through setters.
 */
+static PyObject * ValueProxy_get_age(ValueProxyObject *self, void *closure) {
+    (void)closure;
+
+    if (self->value == NULL || self->value_age_ms < 0) {
+        Py_RETURN_NONE;
+    }
+
+    /* The cached value keeps aging after we got it. */
+    const uint64_t since_cached_ms = (pycsh_stats_now_us() - self->value_cached_us) / 1000;
+    return PyLong_FromUnsignedLongLong((uint64_t)self->value_age_ms + since_cached_ms);
+}
+
 static PyGetSetDef ValueProxy_getsetters[] = {
 
     {"host", (getter)ValueProxy_get_host, (setter)ValueProxy_set_host,
@@ -339,6 +520,8 @@ static PyGetSetDef ValueProxy_getsetters[] = {
      "timeout of the parameter", NULL},
     {"retries", (getter)ValueProxy_get_retries, (setter)ValueProxy_set_retries,
      "available retries of the parameter", NULL},
+    {"age", (getter)ValueProxy_get_age, NULL,
+     "age in milliseconds of the evaluated value, None when unknown or not yet evaluated", NULL},
     {NULL, NULL, NULL, NULL, NULL}  /* Sentinel */
 };
 
@@ -535,10 +718,12 @@ static PyObject * ValueProxy_call(ValueProxyObject *self, PyObject *args, PyObje
  
     int remote = self->remote;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iiiiii:ValueProxy.__call__", kwlist, &self->host, &self->timeout, &self->retries, &self->paramver, &remote, &self->verbose)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iO&iiii:ValueProxy.__call__", kwlist, &self->host, pycsh_parse_timeout, &self->timeout, &self->retries, &self->paramver, &remote, &self->verbose)) {
         return NULL;  // TypeError is thrown
     }
     self->remote = remote;  /* Bitfield */
+    /* A prefetch with the previous options doesn't stand in for these. */
+    self->prefetched = false;
 
     return (PyObject*)Py_NewRef(self);
 }
@@ -564,3 +749,117 @@ PyTypeObject ValueProxyType = {
         that would allow the user to both `list(Parameter(<name>).get_value_array)` and list(Parameter(<name>).get_value_array(remote=True)) */
     .tp_call = (PyCFunctionWithKeywords)ValueProxy_call,
 };
+
+
+PyObject * pycsh_gather(PyObject *self, PyObject *args) {
+    (void)self;
+
+    const Py_ssize_t count = PyTuple_GET_SIZE(args);
+    PyObject * const proxies AUTO_DECREF = PyTuple_New(count);
+    if (proxies == NULL) {
+        return NULL;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject * const item = PyTuple_GET_ITEM(args, i);
+        PyObject * proxy;
+        if (PyObject_TypeCheck(item, &ValueProxyType)) {
+            proxy = Py_NewRef(item);
+        } else if (PyObject_TypeCheck(item, &ParameterType)) {
+            proxy = pycsh_ValueProxy_from_Parameter(&ValueProxyType, (ParameterObject *)item);
+        } else {
+            PyErr_Format(PyExc_TypeError, "Expected ValueProxy or Parameter, not %s", Py_TYPE(item)->tp_name);
+            return NULL;
+        }
+        if (proxy == NULL) {
+            return NULL;
+        }
+        PyTuple_SET_ITEM(proxies, i, proxy);  // Steals reference
+    }
+
+    if (ValueProxy_prefetch((ValueProxyObject **)PySequence_Fast_ITEMS(proxies), count) < 0) {
+        return NULL;
+    }
+
+    PyObject * const values AUTO_DECREF = PyTuple_New(count);
+    if (values == NULL) {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject * const value = ValueProxy_eval_value((ValueProxyObject *)PyTuple_GET_ITEM(proxies, i), NULL);
+        if (value == NULL) {
+            return NULL;
+        }
+        PyTuple_SET_ITEM(values, i, Py_NewRef(value));
+    }
+
+    return Py_NewRef(values);
+}
+
+
+typedef struct {
+    PyObject_HEAD
+    bool entered;
+} GatherScopeObject;
+
+static PyObject * GatherScope_enter(GatherScopeObject *self, PyObject *Py_UNUSED(ignored)) {
+
+    if (self->entered) {
+        PyErr_SetString(PyExc_RuntimeError, "gather_scope is already entered");
+        return NULL;
+    }
+
+    if (gather_pending == NULL) {
+        gather_pending = PyList_New(0);
+        if (gather_pending == NULL) {
+            return NULL;
+        }
+    }
+
+    gather_depth++;
+    self->entered = true;
+
+    return Py_NewRef(self);
+}
+
+static PyObject * GatherScope_exit(GatherScopeObject *self, PyObject *args) {
+    (void)args;
+
+    if (!self->entered) {
+        Py_RETURN_FALSE;
+    }
+    self->entered = false;
+
+    /* Proxies which were never evaluated should not be pulled. */
+    if (--gather_depth == 0) {
+        Py_CLEAR(gather_pending);
+    }
+
+    Py_RETURN_FALSE;
+}
+
+PyObject * pycsh_gather_scope(PyObject *self, PyObject *args) {
+    (void)self;
+    (void)args;
+    return GatherScopeType.tp_alloc(&GatherScopeType, 0);
+}
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef GatherScope_methods[] = {
+    {"__enter__", (PyCFunction)GatherScope_enter, METH_NOARGS, NULL},
+    {"__exit__", (PyCFunction)GatherScope_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
+PyTypeObject GatherScopeType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "pycsh.GatherScope",
+    .tp_doc = "Pulls the values read within it together, returned by pycsh.gather_scope().",
+    .tp_basicsize = sizeof(GatherScopeObject),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_methods = GatherScope_methods,
+};
@@ -19,11 +19,18 @@ typedef struct {
 	int retries;  // TODO Kevin: The 'retries' code was implemented rather hastily, consider refactoring of removing it. 
 	int paramver;
 	bool remote : 1;
+	/* Set by `pycsh.gather()` once `param` has been pulled into the local cache,
+		`value` is then evaluated without pulling again. */
+	bool prefetched : 1;
 	int verbose;
 
 	/* Cached Python value of the parameter,
 		will be NULL before we query it. */
 	PyObject * value;
+	/* `pycsh_param_age_ms()` of `param` when `value` was cached, -1 for unknown. */
+	int64_t value_age_ms;
+	/* `pycsh_stats_now_us()` when `value` was cached. */
+	uint64_t value_cached_us;
 
 	/* TODO Kevin: Can't really decide if we should have indexes here */
 	//PyObject * indexes;
@@ -40,3 +47,12 @@ PyObject * ValueProxy_subscript(ValueProxyObject *self, PyObject *key);
 
 /* Can be used to set the value of a `Parameter`, using a `ValueProxy`. */
 int ValueProxy_ass_subscript(ValueProxyObject *self, PyObject *key, PyObject* value);
+
+/* Track `self` in the `pycsh.gather_scope()` entered by the calling thread, if any,
+	so it is pulled together with the other proxies of the scope. */
+void ValueProxy_gather_track(ValueProxyObject *self);
+
+extern PyTypeObject GatherScopeType;
+
+PyObject * pycsh_gather(PyObject *self, PyObject *args);
+PyObject * pycsh_gather_scope(PyObject *self, PyObject *args);
@@ -0,0 +1,551 @@
+/*
+ * watch.c
+ *
+ * Contains the Watch class, returned by `pycsh.watch()`.
+ * Values of watched parameters are copied into a ring buffer as they are received,
+ * by the pull/push-apply paths and the parameter sniffer.
+ * Consumers read them from Python, and may wait for them with select()/asyncio on `Watch.fileno()`.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/watch.h>
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+
+#include <csp/csp.h>
+#include <csp/csp_hooks.h>
+#include <param/param_list.h>
+
+#include <pycsh/pycsh.h>
+#include <pycsh/utils.h>
+#include <pycsh/parameter.h>
+
+#define WATCH_DEFAULT_MAXLEN 1024
+
+typedef struct {
+	int node;
+	int id;
+	uint32_t index;  // Into `pycsh_watch_t.params`
+} watch_key_t;
+
+/* What a watched parameter looked like when the watch was created.
+	The `param_t` itself may be freed (i.e by "list forget") while we are watching it,
+	so snapshots are decoded from this instead, and only values of a matching parameter are recorded. */
+typedef struct {
+	uint16_t node;
+	uint16_t id;
+	param_type_e type;
+	int array_size;
+	char * name;
+} watch_param_t;
+
+typedef struct pycsh_watch_s {
+	struct pycsh_watch_s * next;
+
+	/* Sorted by (node, id) */
+	watch_key_t * keys;
+	watch_param_t * params;
+	size_t param_count;
+
+	/* Ring buffer of values, `slot_size` bytes per entry. */
+	uint8_t * slots;
+	uint32_t * slot_param;
+	csp_timestamp_t * slot_timestamp;
+	size_t slot_size;
+	size_t capacity;
+	int64_t head;  // Oldest unread entry
+	int64_t tail;  // Next entry to write
+
+	/* Sequence number of the newest unread entry of each parameter, -1 for none. */
+	int64_t * pending;
+	bool coalesce;
+	uint64_t dropped;
+
+	/* Readable while the ring buffer is not empty. */
+	int efd;
+} pycsh_watch_t;
+
+typedef struct {
+	PyObject_HEAD
+	pycsh_watch_t * watch;
+	/* tuple[Parameter] in the order of `watch->params` */
+	PyObject * parameters;
+} WatchObject;
+
+/* Protects the list of watches, and the ring buffers of all of them. */
+static pthread_mutex_t watch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pycsh_watch_t * watches = NULL;
+static atomic_int watch_count = 0;
+
+static int compare_key(const void * a, const void * b) {
+	const watch_key_t * ka = a;
+	const watch_key_t * kb = b;
+	if (ka->node != kb->node) {
+		return (ka->node > kb->node) - (ka->node < kb->node);
+	}
+	return (ka->id > kb->id) - (ka->id < kb->id);
+}
+
+static size_t value_size(param_type_e type, int array_size) {
+	return (size_t)param_typesize(type) * (array_size > 0 ? array_size : 1);
+}
+
+static size_t param_value_size(const param_t * param) {
+	return value_size(param->type, param->array_size);
+}
+
+/* Copy the raw value of `param` into `out`, which must hold `param_value_size(param)` bytes. */
+static void param_snapshot(const param_t * param, uint8_t * out) {
+
+	if (param->vmem != NULL) {
+		param_get_data((param_t *)param, out, param_value_size(param));
+		return;
+	}
+
+	const size_t typesize = param_typesize(param->type);
+	const int count = param->array_size > 0 ? param->array_size : 1;
+	const size_t step = param->array_step > 0 ? (size_t)param->array_step : typesize;
+	for (int i = 0; i < count; i++) {
+		memcpy(&out[i * typesize], (uint8_t *)param->addr + i * step, typesize);
+	}
+}
+
+/* Caller must hold `watch_lock` */
+static void watch_push(pycsh_watch_t * watch, uint32_t index, const param_t * param) {
+
+	/* Parameter has been replaced by one we can't decode. */
+	const watch_param_t * const desc = &watch->params[index];
+	if (param->type != desc->type || param->array_size != desc->array_size) {
+		return;
+	}
+
+	csp_timestamp_t now;
+	csp_clock_get_time(&now);
+
+	/* Newest wins, overwrite the unread value rather than queueing another. */
+	if (watch->coalesce && watch->pending[index] >= watch->head) {
+		const size_t slot = watch->pending[index] % watch->capacity;
+		param_snapshot(param, &watch->slots[slot * watch->slot_size]);
+		watch->slot_timestamp[slot] = now;
+		return;
+	}
+
+	/* Full, drop the oldest value rather than blocking the router. */
+	if ((size_t)(watch->tail - watch->head) == watch->capacity) {
+		const uint32_t oldest = watch->slot_param[watch->head % watch->capacity];
+		if (watch->pending[oldest] == watch->head) {
+			watch->pending[oldest] = -1;
+		}
+		watch->head++;
+		watch->dropped++;
+	}
+
+	const bool was_empty = watch->tail == watch->head;
+	const size_t slot = watch->tail % watch->capacity;
+	param_snapshot(param, &watch->slots[slot * watch->slot_size]);
+	watch->slot_param[slot] = index;
+	watch->slot_timestamp[slot] = now;
+	watch->pending[index] = watch->tail;
+	watch->tail++;
+
+	if (was_empty) {
+		eventfd_write(watch->efd, 1);
+	}
+}
+
+bool pycsh_watch_enabled(void) {
+	return atomic_load_explicit(&watch_count, memory_order_relaxed) > 0;
+}
+
+void pycsh_watch_notify(const param_t * param) {
+
+	if (atomic_load_explicit(&watch_count, memory_order_relaxed) == 0 || param == NULL) {
+		return;
+	}
+
+	const watch_key_t key = {.node = *param->node, .id = param->id};
+
+	pthread_mutex_lock(&watch_lock);
+	for (pycsh_watch_t * watch = watches; watch != NULL; watch = watch->next) {
+		const watch_key_t * const found = bsearch(&key, watch->keys, watch->param_count, sizeof(*watch->keys), compare_key);
+		if (found == NULL) {
+			continue;
+		}
+		watch_push(watch, found->index, param);
+	}
+	pthread_mutex_unlock(&watch_lock);
+}
+
+static void watch_free(pycsh_watch_t * watch) {
+	if (watch == NULL) {
+		return;
+	}
+	if (watch->efd >= 0) {
+		close(watch->efd);
+	}
+	free(watch->keys);
+	for (size_t i = 0; watch->params != NULL && i < watch->param_count; i++) {
+		free(watch->params[i].name);
+	}
+	free(watch->params);
+	free(watch->slots);
+	free(watch->slot_param);
+	free(watch->slot_timestamp);
+	free(watch->pending);
+	free(watch);
+}
+
+/* Copies what it needs from `params`, which remain owned by the caller. */
+static pycsh_watch_t * watch_new(const param_t ** params, size_t param_count, size_t capacity, bool coalesce) {
+
+	pycsh_watch_t * watch = calloc(1, sizeof(*watch));
+	if (watch == NULL) {
+		return NULL;
+	}
+	watch->efd = -1;
+	watch->param_count = param_count;
+	watch->capacity = capacity;
+	watch->coalesce = coalesce;
+
+	for (size_t i = 0; i < param_count; i++) {
+		const size_t size = param_value_size(params[i]);
+		if (size > watch->slot_size) {
+			watch->slot_size = size;
+		}
+	}
+
+	watch->params = calloc(param_count > 0 ? param_count : 1, sizeof(*watch->params));
+	watch->keys = calloc(param_count > 0 ? param_count : 1, sizeof(*watch->keys));
+	watch->slots = calloc(capacity, watch->slot_size > 0 ? watch->slot_size : 1);
+	watch->slot_param = calloc(capacity, sizeof(*watch->slot_param));
+	watch->slot_timestamp = calloc(capacity, sizeof(*watch->slot_timestamp));
+	watch->pending = malloc((param_count > 0 ? param_count : 1) * sizeof(*watch->pending));
+	watch->efd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (!watch->params || !watch->keys || !watch->slots || !watch->slot_param || !watch->slot_timestamp || !watch->pending || watch->efd < 0) {
+		watch_free(watch);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < param_count; i++) {
+		watch->params[i] = (watch_param_t){
+			.node = *params[i]->node,
+			.id = params[i]->id,
+			.type = params[i]->type,
+			.array_size = params[i]->array_size,
+			.name = strdup(params[i]->name ? params[i]->name : ""),
+		};
+		if (watch->params[i].name == NULL) {
+			watch_free(watch);
+			return NULL;
+		}
+		watch->keys[i] = (watch_key_t){.node = *params[i]->node, .id = params[i]->id, .index = i};
+		watch->pending[i] = -1;
+	}
+	qsort(watch->keys, param_count, sizeof(*watch->keys), compare_key);
+
+	return watch;
+}
+
+static void watch_unregister(pycsh_watch_t * watch) {
+	pthread_mutex_lock(&watch_lock);
+	for (pycsh_watch_t ** it = &watches; *it != NULL; it = &(*it)->next) {
+		if (*it == watch) {
+			*it = watch->next;
+			atomic_fetch_sub(&watch_count, 1);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&watch_lock);
+}
+
+/* Convert a value copied by `param_snapshot()` to Python, like `Parameter.value` would. */
+static PyObject * snapshot_to_pyobject(const watch_param_t * desc, const uint8_t * snapshot) {
+
+	/* Detached `param_t`, reading from the snapshot rather than a live parameter. */
+	uint16_t node = desc->node;
+	csp_timestamp_t timestamp = {0};
+	param_t detached = {
+		.id = desc->id,
+		.node = &node,
+		.type = desc->type,
+		.name = desc->name,
+		.addr = (void *)snapshot,
+		.array_size = desc->array_size,
+		.array_step = param_typesize(desc->type),
+		.timestamp = &timestamp,
+	};
+
+	if (desc->array_size > 1 && desc->type != PARAM_TYPE_STRING && desc->type != PARAM_TYPE_DATA) {
+		return _pycsh_util_get_array(&detached, 0, INT_MIN, 0, 0, 2, -1);
+	}
+	return _pycsh_util_get_single(&detached, INT_MIN, 0, INT_MIN, 0, 0, 2, -1);
+}
+
+static void Watch_close_internal(WatchObject * self) {
+	if (self->watch == NULL) {
+		return;
+	}
+	watch_unregister(self->watch);
+	watch_free(self->watch);
+	self->watch = NULL;
+}
+
+static void Watch_dealloc(WatchObject * self) {
+	Watch_close_internal(self);
+	Py_XDECREF(self->parameters);
+	Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+#define WATCH_CLOSED_CHECK(self)                                            \
+	if ((self)->watch == NULL) {                                            \
+		PyErr_SetString(PyExc_ValueError, "Operation on closed Watch");     \
+		return NULL;                                                        \
+	}
+
+static PyObject * Watch_read(WatchObject * self, PyObject * args, PyObject * kwds) {
+
+	WATCH_CLOSED_CHECK(self)
+
+	int timeout = 0;
+	Py_ssize_t max_count = -1;
+
+	static char *kwlist[] = {"timeout", "max_count", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|in:read", kwlist, &timeout, &max_count))
+		return NULL;  // TypeError is thrown
+
+	pycsh_watch_t * const watch = self->watch;
+
+	if (timeout != 0) {
+		/* Wait for the first value, without holding the GIL. */
+		struct pollfd pfd = {.fd = watch->efd, .events = POLLIN};
+		int poll_res;
+		Py_BEGIN_ALLOW_THREADS;
+		poll_res = poll(&pfd, 1, timeout < 0 ? -1 : timeout);
+		Py_END_ALLOW_THREADS;
+		if (poll_res < 0 && PyErr_CheckSignals() < 0) {
+			return NULL;
+		}
+	}
+
+	pthread_mutex_lock(&watch_lock);
+
+	size_t count = watch->tail - watch->head;
+	if (max_count >= 0 && (size_t)max_count < count) {
+		count = max_count;
+	}
+
+	/* Copy out under the lock, convert to Python without it. */
+	uint32_t * const indexes = malloc((count > 0 ? count : 1) * sizeof(*indexes));
+	csp_timestamp_t * const timestamps = malloc((count > 0 ? count : 1) * sizeof(*timestamps));
+	uint8_t * const values = malloc((count > 0 ? count : 1) * (watch->slot_size > 0 ? watch->slot_size : 1));
+	if (!indexes || !timestamps || !values) {
+		pthread_mutex_unlock(&watch_lock);
+		free(indexes);
+		free(timestamps);
+		free(values);
+		return PyErr_NoMemory();
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const size_t slot = watch->head % watch->capacity;
+		indexes[i] = watch->slot_param[slot];
+		timestamps[i] = watch->slot_timestamp[slot];
+		memcpy(&values[i * watch->slot_size], &watch->slots[slot * watch->slot_size], watch->slot_size);
+		if (watch->pending[indexes[i]] == watch->head) {
+			watch->pending[indexes[i]] = -1;
+		}
+		watch->head++;
+	}
+
+	if (watch->head == watch->tail) {
+		eventfd_t discard;
+		eventfd_read(watch->efd, &discard);
+	}
+
+	pthread_mutex_unlock(&watch_lock);
+
+	PyObject * result = PyList_New(count);
+	if (result != NULL) {
+		for (size_t i = 0; i < count; i++) {
+			PyObject * const parameter = PyTuple_GET_ITEM(self->parameters, indexes[i]);
+			PyObject * const value = snapshot_to_pyobject(&watch->params[indexes[i]], &values[i * watch->slot_size]);
+			PyObject * const item = value ? Py_BuildValue("(OOd)", parameter, value, timestamps[i].tv_sec + timestamps[i].tv_nsec / 1E9) : NULL;
+			Py_XDECREF(value);
+			if (item == NULL) {
+				Py_CLEAR(result);
+				break;
+			}
+			PyList_SET_ITEM(result, i, item);  // Steals reference
+		}
+	}
+
+	free(indexes);
+	free(timestamps);
+	free(values);
+	return result;
+}
+
+static PyObject * Watch_fileno(WatchObject * self, PyObject * Py_UNUSED(ignored)) {
+	WATCH_CLOSED_CHECK(self)
+	return PyLong_FromLong(self->watch->efd);
+}
+
+static PyObject * Watch_close(WatchObject * self, PyObject * Py_UNUSED(ignored)) {
+	Watch_close_internal(self);
+	Py_RETURN_NONE;
+}
+
+static PyObject * Watch_enter(WatchObject * self, PyObject * Py_UNUSED(ignored)) {
+	return Py_NewRef(self);
+}
+
+static PyObject * Watch_exit(WatchObject * self, PyObject * args) {
+	Watch_close_internal(self);
+	Py_RETURN_FALSE;
+}
+
+static PyObject * Watch_get_dropped(WatchObject * self, void * closure) {
+	WATCH_CLOSED_CHECK(self)
+	pthread_mutex_lock(&watch_lock);
+	const uint64_t dropped = self->watch->dropped;
+	pthread_mutex_unlock(&watch_lock);
+	return PyLong_FromUnsignedLongLong(dropped);
+}
+
+static PyObject * Watch_get_parameters(WatchObject * self, void * closure) {
+	return Py_NewRef(self->parameters);
+}
+
+static Py_ssize_t Watch_length(WatchObject * self) {
+	if (self->watch == NULL) {
+		return 0;
+	}
+	pthread_mutex_lock(&watch_lock);
+	const Py_ssize_t pending = self->watch->tail - self->watch->head;
+	pthread_mutex_unlock(&watch_lock);
+	return pending;
+}
+
+PyObject * pycsh_watch(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	PyObject * params_in = NULL;
+	Py_ssize_t maxlen = WATCH_DEFAULT_MAXLEN;
+	int coalesce = true;
+
+	static char *kwlist[] = {"params", "maxlen", "coalesce", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|np:watch", kwlist, &params_in, &maxlen, &coalesce))
+		return NULL;  // TypeError is thrown
+
+	if (maxlen < 1) {
+		PyErr_SetString(PyExc_ValueError, "maxlen must be at least 1");
+		return NULL;
+	}
+
+	PyObject * const params_seq AUTO_DECREF = PySequence_Fast(params_in, "params must be an iterable of Parameters or parameter identifiers");
+	if (params_seq == NULL) {
+		return NULL;
+	}
+	const Py_ssize_t param_count = PySequence_Fast_GET_SIZE(params_seq);
+
+	PyObject * parameters AUTO_DECREF = PyTuple_New(param_count);
+	if (parameters == NULL) {
+		return NULL;
+	}
+	const param_t ** params = malloc((param_count > 0 ? param_count : 1) * sizeof(*params));
+	if (params == NULL) {
+		return PyErr_NoMemory();
+	}
+
+	for (Py_ssize_t i = 0; i < param_count; i++) {
+		PyObject * const item = PySequence_Fast_GET_ITEM(params_seq, i);
+		const param_t * const param = _pycsh_util_find_param_t(item, pycsh_dfl_node);
+		if (param == NULL) {
+			free(params);
+			return NULL;  // Raises TypeError or ValueError.
+		}
+		PyObject * const parameter = PyObject_TypeCheck(item, &ParameterType) ?
+			Py_NewRef(item) : pycsh_Parameter_from_param(&ParameterType, param, NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
+		if (parameter == NULL) {
+			free(params);
+			return NULL;
+		}
+		PyTuple_SET_ITEM(parameters, i, parameter);  // Steals reference
+		params[i] = param;
+	}
+
+	WatchObject * const watch_obj = (WatchObject *)WatchType.tp_alloc(&WatchType, 0);
+	if (watch_obj == NULL) {
+		free(params);
+		return NULL;
+	}
+
+	pycsh_watch_t * const watch = watch_new(params, param_count, maxlen, coalesce);
+	free(params);
+	if (watch == NULL) {
+		Py_DECREF(watch_obj);
+		return PyErr_NoMemory();
+	}
+	watch_obj->watch = watch;
+	watch_obj->parameters = Py_NewRef(parameters);
+
+	pthread_mutex_lock(&watch_lock);
+	watch->next = watches;
+	watches = watch;
+	atomic_fetch_add(&watch_count, 1);
+	pthread_mutex_unlock(&watch_lock);
+
+	return (PyObject *)watch_obj;
+}
+
+static PySequenceMethods Watch_as_sequence = {
+	.sq_length = (lenfunc)Watch_length,
+};
+
+static PyGetSetDef Watch_getsetters[] = {
+	{"dropped", (getter)Watch_get_dropped, NULL,
+     "Number of values dropped because the consumer fell more than maxlen values behind.", NULL},
+	{"parameters", (getter)Watch_get_parameters, NULL,
+     "Watched parameters.", NULL},
+    {NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
+/* It seems that pedantic does not like how CPython uses flags to communicate function signature. */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wincompatible-pointer-types"
+static PyMethodDef Watch_methods[] = {
+	{"read", (PyCFunctionWithKeywords)Watch_read, METH_VARARGS | METH_KEYWORDS,
+     PyDoc_STR("Return received values as a list of (Parameter, value, timestamp), waiting up to timeout ms for the first one.")},
+	{"fileno", (PyCFunction)Watch_fileno, METH_NOARGS,
+     PyDoc_STR("File descriptor which is readable while values are pending, for use with select() or asyncio.")},
+	{"close", (PyCFunction)Watch_close, METH_NOARGS,
+     PyDoc_STR("Stop watching, and release the file descriptor.")},
+	{"__enter__", (PyCFunction)Watch_enter, METH_NOARGS, NULL},
+	{"__exit__", (PyCFunction)Watch_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+#pragma GCC diagnostic pop
+
+PyTypeObject WatchType = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	.tp_name = "pycsh.Watch",
+	.tp_doc = "Consumer of parameter values received from the network, returned by pycsh.watch().",
+	.tp_basicsize = sizeof(WatchObject),
+	.tp_itemsize = 0,
+	.tp_flags = Py_TPFLAGS_DEFAULT,
+	.tp_dealloc = (destructor)Watch_dealloc,
+	.tp_as_sequence = &Watch_as_sequence,
+	.tp_methods = Watch_methods,
+	.tp_getset = Watch_getsetters,
+};
@@ -39,10 +39,20 @@
 #include <sys/types.h>
 
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
+#include <pycsh/param_index.h>
+#include <pycsh/watch.h>
+#include <pycsh/history.h>
+#include <pycsh/batch.h>
+#include <pycsh/dispatch.h>
+#include <pycsh/scheduler_tick.h>
+#include <pycsh/router_stats.h>
+#include <pycsh/crc32c.h>
 
 #include <pycsh/parameter.h>
 #include "parameter/pythongetsetparameter.h"
 #include "parameter/parameterlist.h"
+#include "parameter/parameterlistview.h"
 #include "parameter/valueproxy.h"
 
 #include "csp_classes/ident.h"
@@ -69,25 +79,11 @@
 static_assert(sizeof(unsigned int) == sizeof(uint32_t), "Parsing Python arguments, i.e int -> uint32_t");
 
 int pycsh_dfl_verbose = -1;
+unsigned int pycsh_dfl_max_age = 0;
 unsigned int slash_dfl_node __attribute__((weak));
 unsigned int slash_dfl_timeout __attribute__((weak));
 
 
-void * onehz_task(void * param) {
-	(void)param;
-	while(1) {
-#ifdef PARAM_HAVE_SCHEDULER
-		csp_timestamp_t scheduler_time = {};
-        csp_clock_get_time(&scheduler_time);
-        param_schedule_server_update(scheduler_time.tv_sec * 1E9 + scheduler_time.tv_nsec);
-#endif
-		// Py_BEGIN_ALLOW_THREADS;
-		sleep(1);
-		// Py_END_ALLOW_THREADS;
-	}
-	return NULL;
-}
-
 // TODO Kevin: It's probably not safe to call this function consecutively with the same std_stream or stream_buf.
 static int _handle_stream(PyObject * stream_identifier, FILE **std_stream, FILE *stream_buf) {
 	if (stream_identifier == NULL)
@@ -191,6 +187,7 @@ static PyMethodDef methods[] = {
 	{"cmd_new", 	(PyCFunctionWithKeywords)pycsh_param_cmd_new,METH_VARARGS | METH_KEYWORDS,"Create a new command"},
 	{"node", 		(PyCFunctionWithKeywords)pycsh_slash_node, 	METH_VARARGS | METH_KEYWORDS, "Used to get or change the default node."},
 	{"timeout", 	(PyCFunctionWithKeywords)pycsh_slash_timeout,METH_VARARGS | METH_KEYWORDS,"Used to get or change the default timeout."},
+	{"max_age", 	(PyCFunctionWithKeywords)pycsh_slash_max_age,METH_VARARGS | METH_KEYWORDS,"Used to get or change the maximum age of cached remote values."},
 	{"verbose", 	pycsh_slash_verbose, 			METH_VARARGS, 		  		  "Used to get or change the default parameter verbosity."},
 	{"queue", 		pycsh_param_cmd,			  	METH_NOARGS, 				  "Print the current command."},
 
@@ -200,6 +197,16 @@ static PyMethodDef methods[] = {
 	{"list_forget", (PyCFunctionWithKeywords)pycsh_param_list_forget, 	  METH_VARARGS | METH_KEYWORDS, "Remove remote parameters, matching the provided arguments, from the global list."},
 	{"list_save", 	(PyCFunctionWithKeywords)pycsh_param_list_save, 	  METH_VARARGS | METH_KEYWORDS, "Save a list of parameters to a file."},
 	{"list_add", 	(PyCFunctionWithKeywords)pycsh_param_list_add, 	      METH_VARARGS | METH_KEYWORDS, "Add a paramter to the global list."},
+	{"list_index_stats", (PyCFunctionWithKeywords)pycsh_param_index_stats, METH_VARARGS | METH_KEYWORDS, "Return hit/miss counters of the parameter name/id lookup index."},
+	{"watch", 		(PyCFunctionWithKeywords)pycsh_watch, 	METH_VARARGS | METH_KEYWORDS, "Receive values of the specified parameters as they arrive from the network."},
+	{"history", 	(PyCFunctionWithKeywords)pycsh_history, METH_VARARGS | METH_KEYWORDS, "Return the recently received values of a parameter."},
+	{"history_enable", (PyCFunctionWithKeywords)pycsh_history_enable, METH_VARARGS | METH_KEYWORDS, "Keep the last received values of matching parameters in memory."},
+	{"history_disable", (PyCFunction)pycsh_history_disable, METH_NOARGS, "Stop keeping parameter history, and forget all rules."},
+	{"callback_dispatch", (PyCFunctionWithKeywords)pycsh_callback_dispatch, METH_VARARGS | METH_KEYWORDS, "Call Parameter callbacks from a dedicated thread, rather than the thread which received the value."},
+	{"callback_dispatch_stats", (PyCFunctionWithKeywords)pycsh_callback_dispatch_stats, METH_VARARGS | METH_KEYWORDS, "Return queue depth and latency counters of deferred callback dispatch."},
+	{"gather", 		(PyCFunction)pycsh_gather, 	METH_VARARGS, "Evaluate the provided ValueProxy objects, pulling them with one request per node."},
+	{"gather_scope", (PyCFunction)pycsh_gather_scope, METH_NOARGS, "Pull the values of Parameter.value read within the returned context together."},
+	{"batch", 		(PyCFunctionWithKeywords)pycsh_batch, 	METH_VARARGS | METH_KEYWORDS, "Queue remote parameter writes, and push them together when the returned context exits."},
 
 	// {"list_load", 	pycsh_param_list_load, 		  	METH_VARARGS, 				  "Load a list of parameters from a file."},
 
@@ -214,6 +221,12 @@ static PyMethodDef methods[] = {
 	/* Utility functions */
 	{"get_type", 	pycsh_util_get_type, 		  	METH_VARARGS, 				  "Gets the type of the specified parameter."},
 	{"slash_execute", (PyCFunctionWithKeywords)pycsh_slash_execute, 			METH_VARARGS | METH_KEYWORDS, "Execute string as a slash command. Used to run .csh scripts"},
+	{"stats", 		(PyCFunctionWithKeywords)pycsh_stats, 			METH_VARARGS | METH_KEYWORDS, "Return per-node transaction counters and latency histograms."},
+	{"crc32", (PyCFunctionWithKeywords)pycsh_crc32, METH_VARARGS | METH_KEYWORDS, "Return the CRC32C (as used by CSP) of a bytes-like object."},
+	{"router_stats", (PyCFunctionWithKeywords)pycsh_router_stats, METH_VARARGS | METH_KEYWORDS, "Return iteration, busy time and callback time counters of the CSP router workers."},
+	{"scheduler_tick", (PyCFunctionWithKeywords)pycsh_scheduler_tick, METH_VARARGS | METH_KEYWORDS, "Serve the libparam scheduler at the specified rate (Hz) from a dedicated thread."},
+	{"scheduler_wake", (PyCFunctionWithKeywords)pycsh_scheduler_wake, METH_VARARGS | METH_KEYWORDS, "Serve the libparam scheduler after the specified delay, in addition to the regular ticks."},
+	{"scheduler_tick_stats", (PyCFunctionWithKeywords)pycsh_scheduler_tick_stats, METH_VARARGS | METH_KEYWORDS, "Return tick, overrun and jitter counters of the scheduler tick."},
 
 	/* Converted vmem commands from libparam/src/vmem/vmem_client_slash.c */
 	{"vmem", 	(PyCFunctionWithKeywords)pycsh_param_vmem,   METH_VARARGS | METH_KEYWORDS, "Builds a string of the vmem at the specified node."},
@@ -221,6 +234,7 @@ static PyMethodDef methods[] = {
 	/* Converted vmem commands from libparam/src/vmem/vmem_client.c */
 	{"vmem_download", (PyCFunctionWithKeywords)pycsh_vmem_download,   METH_VARARGS | METH_KEYWORDS, "Download a vmem area."},
 	{"vmem_upload", (PyCFunctionWithKeywords)pycsh_vmem_upload,   METH_VARARGS | METH_KEYWORDS, "Upload data to a vmem area."},
+	{"vmem_benchmark", (PyCFunctionWithKeywords)pycsh_vmem_benchmark,   METH_VARARGS | METH_KEYWORDS, "Sweep RDP options while transferring a vmem area, and recommend the fastest reliable configuration."},
 
 	/* Converted program/reboot commands from csh/src/spaceboot_slash.c */
 	{"switch", 	(PyCFunctionWithKeywords)slash_csp_switch,   METH_VARARGS | METH_KEYWORDS, "Reboot into the specified firmware slot."},
@@ -250,42 +264,47 @@ static PyMethodDef methods[] = {
 };
 #pragma GCC diagnostic pop
 
-static struct PyModuleDef moduledef = {
-	PyModuleDef_HEAD_INIT,
-	"pycsh",
-	"Bindings primarily dedicated to the CSH shell interface commands",
-	-1,
-	methods,
-	NULL,
-	NULL,
-	NULL,
-	NULL};
-
-PyMODINIT_FUNC PyInit_pycsh(void) {
-
-	/* AUTO_DECREF for exception handling */
-	PyObject * pycsh AUTO_DECREF = PyModule_Create(&moduledef);
-	if (pycsh == NULL)
-		return NULL;
+/* Returns `pycsh` (borrowed) when populated, otherwise NULL with an exception set. */
+static PyObject * pycsh_populate(PyObject * pycsh) {
 
-	{  /* Exceptions */
+	/* Exceptions are shared by every module object, should the module be imported again. */
+	if (PyExc_ProgramDiffError == NULL) {
 		PyExc_ProgramDiffError = PyErr_NewExceptionWithDoc("pycsh.ProgramDiffError", 
 			"Raised when a difference is detected between uploaded/downloaded data after programming.\n"
 			"Must be caught before ConnectionError() baseclass.",
 			PyExc_ConnectionError, NULL);
-		PyModule_AddObject_ErrCheck(pycsh, "ProgramDiffError", PyExc_ProgramDiffError);
+		if (PyExc_ProgramDiffError == NULL) {
+			return NULL;
+		}
+	}
+	if (PyModule_AddObjectRef(pycsh, "ProgramDiffError", PyExc_ProgramDiffError) < 0) {
+		return NULL;
+	}
 
+	if (PyExc_ParamCallbackError == NULL) {
 		PyExc_ParamCallbackError = PyErr_NewExceptionWithDoc("pycsh.ParamCallbackError", 
 			"Raised and chains unto exceptions raised in the callbacks of PythonParameters.\n"
 			"Must be caught before RuntimeError() baseclass.",
 			PyExc_RuntimeError, NULL);
-		PyModule_AddObject_ErrCheck(pycsh, "ParamCallbackError", PyExc_ParamCallbackError);
+		if (PyExc_ParamCallbackError == NULL) {
+			return NULL;
+		}
+	}
+	if (PyModule_AddObjectRef(pycsh, "ParamCallbackError", PyExc_ParamCallbackError) < 0) {
+		return NULL;
+	}
 
+	if (PyExc_InvalidParameterTypeError == NULL) {
 		PyExc_InvalidParameterTypeError = PyErr_NewExceptionWithDoc("pycsh.InvalidParameterTypeError", 
 			"Raised when attempting to create a new PythonParameter() with an invalid type.\n"
 			"Must be caught before ValueError() baseclass.",
 			PyExc_ValueError, NULL);
-		PyModule_AddObject_ErrCheck(pycsh, "ParamCallbackError", PyExc_InvalidParameterTypeError);
+		if (PyExc_InvalidParameterTypeError == NULL) {
+			return NULL;
+		}
+	}
+	if (PyModule_AddObjectRef(pycsh, "InvalidParameterTypeError", PyExc_InvalidParameterTypeError) < 0) {
+		return NULL;
 	}
 
 	if (PyModule_AddType(pycsh, &ValueProxyType) < 0) {
@@ -317,6 +336,26 @@ PyMODINIT_FUNC PyInit_pycsh(void) {
 		return NULL;
 	}
 
+	if (PyModule_AddType(pycsh, &ParameterListViewType) < 0) {
+		return NULL;
+	}
+
+	if (PyModule_AddType(pycsh, &WatchType) < 0) {
+		return NULL;
+	}
+
+	if (PyModule_AddType(pycsh, &ParameterHistoryType) < 0) {
+		return NULL;
+	}
+
+	if (PyModule_AddType(pycsh, &BatchType) < 0) {
+		return NULL;
+	}
+
+	if (PyModule_AddType(pycsh, &GatherScopeType) < 0) {
+		return NULL;
+	}
+
 
 	if (PyModule_AddType(pycsh, &IdentType) < 0) {
         return NULL;
@@ -424,7 +463,38 @@ PyMODINIT_FUNC PyInit_pycsh(void) {
 
     #undef PyModule_AddObject_ErrCheck
 
-	param_callback_dict = (PyDictObject *)PyDict_New();
+	if (param_callback_dict == NULL) {
+		param_callback_dict = (PyDictObject *)PyDict_New();
+		if (param_callback_dict == NULL) {
+			return NULL;
+		}
+	}
+
+	return pycsh;
+}
+
+static struct PyModuleDef moduledef = {
+	PyModuleDef_HEAD_INIT,
+	"pycsh",
+	"Bindings primarily dedicated to the CSH shell interface commands",
+	-1,
+	methods,
+	NULL,
+	NULL,
+	NULL,
+	NULL};
+
+PyMODINIT_FUNC PyInit_pycsh(void) {
+
+	/* Single-phase init, as `__init__.py` calls us through ctypes and expects a module back.
+		libcsp and libparam are process-wide singletons, so per-module state would not buy us subinterpreter support anyway. */
+	/* AUTO_DECREF for exception handling */
+	PyObject * pycsh AUTO_DECREF = PyModule_Create(&moduledef);
+	if (pycsh == NULL)
+		return NULL;
+
+	if (pycsh_populate(pycsh) == NULL)
+		return NULL;
 
 	return Py_NewRef(pycsh);  // `Py_NewRef()` needed because we use AUTO_DECREF for exception handling.
 }
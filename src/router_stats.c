@@ -0,0 +1,134 @@
+/*
+ * router_stats.c
+ *
+ * Counters for the CSP router thread started by `pycsh.csp_init()`.
+ * Meant to explain dropped packets on loaded hosts, i.e whether the router is preempted,
+ * kept busy by Python callbacks, or running out of buffers.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/router_stats.h>
+
+#include <limits.h>
+#include <stdatomic.h>
+#include <sys/resource.h>
+
+#include <csp/csp.h>
+#include <csp/csp_buffer.h>
+
+#include <pycsh/utils.h>
+#include <pycsh/stats.h>
+
+static _Thread_local bool is_router_worker = false;
+/* Involuntary context switches of this worker, when it last sampled them. */
+static _Thread_local long last_nivcsw = 0;
+
+static _Atomic uint64_t iterations = 0;
+static _Atomic uint64_t routed = 0;
+static _Atomic uint64_t busy_us_total = 0;
+static _Atomic uint64_t busy_us_max = 0;
+static _Atomic uint64_t callbacks = 0;
+static _Atomic uint64_t callback_us_total = 0;
+static _Atomic uint64_t callback_us_max = 0;
+static _Atomic uint64_t preempted = 0;
+/* INT_MAX until the first routed packet. */
+static atomic_int buffers_free_min = INT_MAX;
+
+static void atomic_max(_Atomic uint64_t * target, uint64_t value) {
+	uint64_t current = atomic_load_explicit(target, memory_order_relaxed);
+	while (value > current && !atomic_compare_exchange_weak_explicit(target, &current, value, memory_order_relaxed, memory_order_relaxed));
+}
+
+static long thread_nivcsw(void) {
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) < 0) {
+		return 0;
+	}
+	return usage.ru_nivcsw;
+}
+
+void pycsh_router_worker_register(void) {
+	is_router_worker = true;
+	last_nivcsw = thread_nivcsw();
+}
+
+void pycsh_router_record_work(uint64_t start_us, bool was_routed) {
+
+	atomic_fetch_add_explicit(&iterations, 1, memory_order_relaxed);
+
+	if (!was_routed) {
+		/* The FIFO timed out, which happens at most every 100 ms, so this is a cheap time to sample the rusage. */
+		const long nivcsw = thread_nivcsw();
+		if (nivcsw > last_nivcsw) {
+			atomic_fetch_add_explicit(&preempted, nivcsw - last_nivcsw, memory_order_relaxed);
+		}
+		last_nivcsw = nivcsw;
+		return;
+	}
+
+	const uint64_t busy_us = pycsh_stats_now_us() - start_us;
+	atomic_fetch_add_explicit(&routed, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&busy_us_total, busy_us, memory_order_relaxed);
+	atomic_max(&busy_us_max, busy_us);
+
+	const int buffers_free = csp_buffer_remaining();
+	int current = atomic_load_explicit(&buffers_free_min, memory_order_relaxed);
+	while (buffers_free < current && !atomic_compare_exchange_weak_explicit(&buffers_free_min, &current, buffers_free, memory_order_relaxed, memory_order_relaxed));
+}
+
+void pycsh_router_record_callback(uint64_t start_us) {
+
+	if (!is_router_worker) {
+		return;
+	}
+
+	const uint64_t callback_us = pycsh_stats_now_us() - start_us;
+	atomic_fetch_add_explicit(&callbacks, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&callback_us_total, callback_us, memory_order_relaxed);
+	atomic_max(&callback_us_max, callback_us);
+}
+
+static uint64_t counter_read(_Atomic uint64_t * counter, bool reset) {
+	if (reset) {
+		return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+	}
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+PyObject * pycsh_router_stats(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int reset = 0;
+
+	static char *kwlist[] = {"reset", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p:router_stats", kwlist, &reset))
+		return NULL;  // TypeError is thrown
+
+	if (!csp_router_is_running()) {
+		PyErr_SetString(PyExc_RuntimeError, "Cannot perform operations before .csp_init() has been called.");
+		return NULL;
+	}
+
+	const int free_min = reset ? atomic_exchange(&buffers_free_min, INT_MAX) : atomic_load(&buffers_free_min);
+
+	/* libcsp's own drop counters are 8-bit and wrap around, so they are reported as-is, and never reset. */
+	return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:K,s:i,s:i,s:i,s:i,s:i,s:i}",
+		"iterations", (unsigned long long)counter_read(&iterations, reset),
+		"routed", (unsigned long long)counter_read(&routed, reset),
+		"busy_us_total", (unsigned long long)counter_read(&busy_us_total, reset),
+		"busy_us_max", (unsigned long long)counter_read(&busy_us_max, reset),
+		"callbacks", (unsigned long long)counter_read(&callbacks, reset),
+		"callback_us_total", (unsigned long long)counter_read(&callback_us_total, reset),
+		"callback_us_max", (unsigned long long)counter_read(&callback_us_max, reset),
+		"preempted", (unsigned long long)counter_read(&preempted, reset),
+		"buffers_free", csp_buffer_remaining(),
+		"buffers_free_min", free_min == INT_MAX ? -1 : free_min,
+		"buffer_out", (int)csp_dbg_buffer_out,
+		"conn_overflow", (int)csp_dbg_conn_ovf,
+		"conn_out", (int)csp_dbg_conn_out,
+		"no_route", (int)csp_dbg_conn_noroute
+	);
+}
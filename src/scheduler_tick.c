@@ -0,0 +1,302 @@
+/*
+ * scheduler_tick.c
+ *
+ * Drives `param_schedule_server_update()` from a timerfd armed at absolute deadlines,
+ * so the tick neither drifts like a `sleep()` loop, nor is limited to 1 Hz.
+ * Ticks stay phase-locked to when the tick was started. Missed ticks are counted as overruns, rather than made up for.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/scheduler_tick.h>
+
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/timerfd.h>
+
+#include <param/param.h>
+#include <csp/csp_hooks.h>
+
+#include <pycsh/utils.h>
+
+/* Protects starting and stopping the thread. Held while `tick_stop()` waits without the GIL,
+	so it must be a real mutex, and must be taken without the GIL. */
+static pthread_mutex_t tick_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool tick_running = false;
+static pthread_t tick_thread;
+static int tick_fd = -1;
+
+static _Atomic uint64_t period_ns = 0;
+static atomic_bool stop_requested = false;
+/* Absolute CLOCK_MONOTONIC deadlines. `wake_ns` is 0 when no extra wakeup is requested. */
+static _Atomic uint64_t wake_ns = 0;
+static _Atomic uint64_t armed_ns = 0;
+
+static _Atomic uint64_t ticks = 0;
+static _Atomic uint64_t wakeups = 0;
+static _Atomic uint64_t overruns = 0;
+static _Atomic uint64_t jitter_us_last = 0;
+static _Atomic uint64_t jitter_us_max = 0;
+static _Atomic uint64_t jitter_us_total = 0;
+static _Atomic uint64_t update_us_max = 0;
+
+static uint64_t monotonic_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void atomic_max(_Atomic uint64_t * target, uint64_t value) {
+	uint64_t current = atomic_load_explicit(target, memory_order_relaxed);
+	while (value > current && !atomic_compare_exchange_weak_explicit(target, &current, value, memory_order_relaxed, memory_order_relaxed));
+}
+
+static int tick_arm(uint64_t deadline_ns) {
+	const struct itimerspec its = {
+		.it_value = {.tv_sec = deadline_ns / 1000000000ULL, .tv_nsec = deadline_ns % 1000000000ULL},
+	};
+	atomic_store_explicit(&armed_ns, deadline_ns, memory_order_release);
+	return timerfd_settime(tick_fd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+static void scheduler_update(void) {
+#ifdef PARAM_HAVE_SCHEDULER
+	csp_timestamp_t scheduler_time = {0};
+	csp_clock_get_time(&scheduler_time);
+	param_schedule_server_update(scheduler_time.tv_sec * 1E9 + scheduler_time.tv_nsec);
+#endif
+}
+
+static void * tick_task(void * arg) {
+	(void)arg;
+
+	const uint64_t period = atomic_load(&period_ns);
+	uint64_t next_ns = monotonic_ns() + period;
+
+	while (!atomic_load_explicit(&stop_requested, memory_order_acquire)) {
+
+		const uint64_t wake = atomic_load_explicit(&wake_ns, memory_order_acquire);
+		const uint64_t deadline = (wake != 0 && wake < next_ns) ? wake : next_ns;
+		tick_arm(deadline);
+
+		/* `tick_stop()` may have armed its immediate expiry before we re-armed, which would leave it waiting a full period. */
+		if (atomic_load(&stop_requested)) {
+			break;
+		}
+
+		/* `pycsh_scheduler_tick_wake()` may have armed an earlier deadline before we re-armed. */
+		if (atomic_load_explicit(&wake_ns, memory_order_acquire) != wake) {
+			continue;
+		}
+
+		uint64_t expirations;
+		if (read(tick_fd, &expirations, sizeof(expirations)) < 0) {
+			if (errno == EINTR || errno == EAGAIN) {
+				continue;
+			}
+			break;
+		}
+		if (atomic_load_explicit(&stop_requested, memory_order_acquire)) {
+			break;
+		}
+
+		const uint64_t now = monotonic_ns();
+		/* Re-arming to an earlier deadline may have woken us early, which is not jitter. */
+		if (now >= deadline) {
+			const uint64_t jitter_us = (now - deadline) / 1000;
+			atomic_store_explicit(&jitter_us_last, jitter_us, memory_order_relaxed);
+			atomic_fetch_add_explicit(&jitter_us_total, jitter_us, memory_order_relaxed);
+			atomic_max(&jitter_us_max, jitter_us);
+		}
+
+		uint64_t current_wake = atomic_load_explicit(&wake_ns, memory_order_acquire);
+		if (current_wake != 0 && current_wake <= now) {
+			atomic_compare_exchange_strong(&wake_ns, &current_wake, 0);
+		}
+
+		scheduler_update();
+		atomic_max(&update_us_max, (monotonic_ns() - now) / 1000);
+
+		if (now >= next_ns) {
+			atomic_fetch_add_explicit(&ticks, 1, memory_order_relaxed);
+			const uint64_t missed = (now - next_ns) / period;
+			atomic_fetch_add_explicit(&overruns, missed, memory_order_relaxed);
+			next_ns += (missed + 1) * period;
+		} else {
+			atomic_fetch_add_explicit(&wakeups, 1, memory_order_relaxed);
+		}
+	}
+
+	return NULL;
+}
+
+/* Caller must hold `tick_lock` */
+static int tick_start(uint64_t period) {
+
+	if (tick_fd < 0) {
+		tick_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+		if (tick_fd < 0) {
+			PyErr_SetFromErrno(PyExc_OSError);
+			return -1;
+		}
+	}
+
+	atomic_store(&period_ns, period);
+	atomic_store(&stop_requested, false);
+	atomic_store(&wake_ns, 0);
+
+	const int res = pthread_create(&tick_thread, NULL, tick_task, NULL);
+	if (res != 0) {
+		errno = res;
+		PyErr_SetFromErrno(PyExc_OSError);
+		return -1;
+	}
+	tick_running = true;
+	return 0;
+}
+
+/* Caller must hold `tick_lock` */
+static void tick_stop(void) {
+
+	atomic_store(&stop_requested, true);  // Sequentially consistent, paired with the check after `tick_arm()` in `tick_task()`.
+	tick_arm(1);  // In the past, so it expires immediately.
+
+	Py_BEGIN_ALLOW_THREADS;  // The scheduler may call Parameter callbacks, which need the GIL.
+	pthread_join(tick_thread, NULL);
+	Py_END_ALLOW_THREADS;
+	tick_running = false;
+	atomic_store(&period_ns, 0);
+}
+
+int pycsh_scheduler_tick_wake(uint64_t deadline_ns) {
+
+	if (atomic_load(&period_ns) == 0) {
+		return -1;
+	}
+
+	uint64_t current = atomic_load_explicit(&wake_ns, memory_order_acquire);
+	do {
+		if (current != 0 && current <= deadline_ns) {
+			return 0;  // An earlier wakeup is already requested.
+		}
+	} while (!atomic_compare_exchange_weak_explicit(&wake_ns, &current, deadline_ns, memory_order_acq_rel, memory_order_acquire));
+
+	if (deadline_ns < atomic_load_explicit(&armed_ns, memory_order_acquire)) {
+		tick_arm(deadline_ns);
+	}
+	return 0;
+}
+
+PyObject * pycsh_scheduler_tick(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	double rate = -1;
+
+	static char *kwlist[] = {"rate", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|d:scheduler_tick", kwlist, &rate))
+		return NULL;  // TypeError is thrown
+
+#ifndef PARAM_HAVE_SCHEDULER
+	if (rate > 0) {
+		PyErr_SetString(PyExc_NotImplementedError, "libparam was built without the scheduler");
+		return NULL;
+	}
+#endif
+
+	if (rate > 1E6) {
+		PyErr_SetString(PyExc_ValueError, "rate must be at most 1 MHz");
+		return NULL;
+	}
+
+	/* Callbacks called by the scheduler run on our thread, which `tick_stop()` would wait for.
+		`tick_running` can't change under the tick thread. */
+	if (tick_running && pthread_equal(pthread_self(), tick_thread)) {
+		if (rate >= 0) {
+			PyErr_SetString(PyExc_RuntimeError, "The scheduler tick cannot be changed from the scheduler itself");
+			return NULL;
+		}
+		const uint64_t period = atomic_load(&period_ns);
+		return PyFloat_FromDouble(period ? 1E9 / period : 0.0);
+	}
+
+	Py_BEGIN_ALLOW_THREADS;  // Another thread may hold `tick_lock` while stopping, and need the GIL to do so.
+	pthread_mutex_lock(&tick_lock);
+	Py_END_ALLOW_THREADS;
+
+	int res = 0;
+	if (rate >= 0) {
+		if (tick_running) {
+			tick_stop();
+		}
+		if (rate > 0) {
+			res = tick_start((uint64_t)(1E9 / rate));
+		}
+	}
+	const uint64_t period = atomic_load(&period_ns);
+
+	pthread_mutex_unlock(&tick_lock);
+
+	if (res < 0) {
+		return NULL;
+	}
+	return PyFloat_FromDouble(period ? 1E9 / period : 0.0);
+}
+
+PyObject * pycsh_scheduler_wake(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	double delay;
+
+	static char *kwlist[] = {"delay", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "d:scheduler_wake", kwlist, &delay))
+		return NULL;  // TypeError is thrown
+
+	if (delay < 0) {
+		delay = 0;
+	}
+
+	if (pycsh_scheduler_tick_wake(monotonic_ns() + (uint64_t)(delay * 1E9)) < 0) {
+		PyErr_SetString(PyExc_RuntimeError, "The scheduler tick is not running, see `pycsh.scheduler_tick()`");
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
+static uint64_t counter_read(_Atomic uint64_t * counter, bool reset) {
+	if (reset) {
+		return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+	}
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+PyObject * pycsh_scheduler_tick_stats(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int reset = 0;
+
+	static char *kwlist[] = {"reset", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|p:scheduler_tick_stats", kwlist, &reset))
+		return NULL;  // TypeError is thrown
+
+	const uint64_t period = atomic_load(&period_ns);
+
+	return Py_BuildValue("{s:d,s:K,s:K,s:K,s:K,s:K,s:K,s:K}",
+		"rate", period ? 1E9 / period : 0.0,
+		"ticks", (unsigned long long)counter_read(&ticks, reset),
+		"wakeups", (unsigned long long)counter_read(&wakeups, reset),
+		"overruns", (unsigned long long)counter_read(&overruns, reset),
+		"jitter_us_last", (unsigned long long)atomic_load_explicit(&jitter_us_last, memory_order_relaxed),
+		"jitter_us_max", (unsigned long long)counter_read(&jitter_us_max, reset),
+		"jitter_us_total", (unsigned long long)counter_read(&jitter_us_total, reset),
+		"update_us_max", (unsigned long long)counter_read(&update_us_max, reset)
+	);
+}
@@ -9,9 +9,6 @@
 #include <pycsh/utils.h>
 
 
-#define min(a, b) (((a) < (b)) ? (a) : (b))
-
-
 /* The main_thread_state is mostly needed by apm.c. But we define it here,
     so it's also visible when not compiling as APM. */
 __attribute__((weak)) 
@@ -32,12 +29,13 @@ PythonSlashCommandObject *python_wraps_slash_command(const struct slash_command
     return (PythonSlashCommandObject *)((char *)command - offsetof(PythonSlashCommandObject, command_heap));
 }
 
+/* Returns a new reference to the resolved type-hint, or `hint` itself when it can't be resolved. */
 static PyObject *typecast_future_typehint(PyObject *hint) {
     // If hint is a string (from __future__ import annotations), try to resolve it
     if (!hint || !PyUnicode_Check(hint)) {
         /* Already not a string, return as is. */
         /* Could also be NULL, in which case we've probably been given an exception. */
-        return hint;
+        return Py_XNewRef(hint);
     }
 
     // Get the function's global namespace
@@ -57,9 +55,10 @@ static PyObject *typecast_future_typehint(PyObject *hint) {
     if (resolved_hint && PyType_Check(resolved_hint)) {
         return resolved_hint;
     }
+    Py_XDECREF(resolved_hint);
 
     // else: leave hint as string, will fallback to default value below
-    return hint;
+    return Py_NewRef(hint);
 }
 
 /**
@@ -122,79 +121,114 @@ static /*PyDictObject*/PyObject * get_parameter_types(PyObject *py_func) {
 #endif
 
 /**
- * @brief Parse positional and named slash arguments, supporting short options if enabled.
+ * @brief (Re)build the cached signature of `self->py_slash_func`.
  *
- * @param self PythonSlashCommandObject containing the Python function and short_opts flag
- * @param slash Slash context
- * @param args_out Output tuple for positional args
- * @param kwargs_out Output dict for keyword args
- * @return int 0 on success, -1 on error
+ * Deriving parameter names and type-hints requires Python introspection,
+ * which is far too slow to repeat for every invocation of the slash command.
+ *
+ * @return 0 on success, -1 with an exception set.
  */
-int pycsh_parse_slash_args(PythonSlashCommandObject *self, const struct slash *slash, PyObject **args_out, PyObject **kwargs_out) {
+static int PythonSlashCommand_build_signature(PythonSlashCommandObject *self) {
+
+    Py_CLEAR(self->sig_code);
+    Py_CLEAR(self->sig_varnames);
+    Py_CLEAR(self->sig_types);
+    memset(self->sig_short, 0, sizeof(self->sig_short));
+
     PyObject *py_func = self->py_slash_func;
-    const bool short_opts = self->short_opts;
+    if (py_func == NULL || py_func == Py_None) {
+        return 0;
+    }
 
-    PyObject *func_code AUTO_DECREF = PyObject_GetAttrString(py_func, "__code__");
-    PyObject *co_varnames AUTO_DECREF = PyObject_GetAttrString(func_code, "co_varnames");
-    PyObject *annotations AUTO_DECREF = PyObject_GetAttrString(py_func, "__annotations__");
+    PyObject *func_code = PyObject_GetAttrString(py_func, "__code__");
+    PyObject *co_varnames AUTO_DECREF = func_code ? PyObject_GetAttrString(func_code, "co_varnames") : NULL;
+    PyObject *co_argcount_obj AUTO_DECREF = func_code ? PyObject_GetAttrString(func_code, "co_argcount") : NULL;
+    if (!co_varnames || !PyTuple_Check(co_varnames) || !co_argcount_obj || !PyLong_Check(co_argcount_obj)) {
+        Py_XDECREF(func_code);
+        PyErr_SetString(PyExc_TypeError, "Unable to inspect function parameters");
+        return -1;
+    }
+    self->sig_code = func_code;  // Steal reference
 
-    /* First build map of function parameter types. Especially for boolean parameters for now. */
-    PyObject *param_name_map[256] = {NULL};
-    PyTypeObject *param_type_map[256] = {NULL};
-    PyObject *param_type_dict AUTO_DECREF = PyDict_New();
-    if (param_type_dict == NULL) {
+    const Py_ssize_t co_argcount = PyLong_AsSsize_t(co_argcount_obj);
+    /* `co_varnames` also holds local variables, which are not parameters. */
+    self->sig_varnames = PyTuple_GetSlice(co_varnames, 0, co_argcount);
+    self->sig_types = PyDict_New();
+    if (self->sig_varnames == NULL || self->sig_types == NULL) {
         return -1;
     }
-    
-    {   /* Build dict of type-cast types. Prefer annotations, but fall back to type of defaults. */
-        PyObject *co_argcount_obj AUTO_DECREF = PyObject_GetAttrString(func_code, "co_argcount");
-        if (!co_varnames || !PyTuple_Check(co_varnames) || !co_argcount_obj || !PyLong_Check(co_argcount_obj)) {
-            PyErr_SetString(PyExc_TypeError, "Unable to inspect function parameters for short opts");
+
+    PyObject *annotations AUTO_DECREF = PyObject_GetAttrString(py_func, "__annotations__");
+    PyObject *defaults AUTO_DECREF = PyObject_GetAttrString(py_func, "__defaults__");
+    PyErr_Clear();  // Both are optional
+    const Py_ssize_t num_defaults = (defaults && PyTuple_Check(defaults)) ? PyTuple_GET_SIZE(defaults) : 0;
+
+    /* Build dict of type-cast types. Prefer annotations, but fall back to type of defaults. */
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(self->sig_varnames); ++i) {
+        PyObject *name_obj = PyTuple_GET_ITEM(self->sig_varnames, i); // borrowed
+        if (!PyUnicode_Check(name_obj)) {
+            continue;
+        }
+
+        const char *name = PyUnicode_AsUTF8(name_obj);
+        if (!name || !name[0]) {
+            continue;
+        }
+        if (self->short_opts && i < UINT8_MAX) {  /* Build short-opts mapping. */
+            self->sig_short[(unsigned char)name[0]] = i + 1;
+        }
+
+        PyObject *hint AUTO_DECREF = (annotations && PyDict_Check(annotations)) ?
+            typecast_future_typehint(PyDict_GetItem(annotations, name_obj)) : NULL;
+        if (PyErr_Occurred()) {
             return -1;
         }
-        Py_ssize_t co_argcount = PyLong_AsSsize_t(co_argcount_obj);
-        for (Py_ssize_t i = 0; i < co_argcount; ++i) {
-            PyObject *name_obj = PyTuple_GetItem(co_varnames, i); // borrowed
-            if (!name_obj || !PyUnicode_Check(name_obj)) {
-                continue;
-            }
 
-            const char *name = PyUnicode_AsUTF8(name_obj);
-            if (!name || !name[0]) {
-                continue;
+        if (hint && PyType_Check(hint)) {
+            if (PyDict_SetItem(self->sig_types, name_obj, hint) < 0) {
+                return -1;
             }
-            if (short_opts) {  /* Build short-opts mapping. */
-                unsigned char first = (unsigned char)name[0];
-                param_name_map[first] = name_obj;
+            continue;
+        }
+
+        /* No type-hint, defer to type of default. */
+        const Py_ssize_t default_idx = i - (co_argcount - num_defaults);
+        if (default_idx >= 0 && default_idx < num_defaults) {
+            PyObject *default_val = PyTuple_GET_ITEM(defaults, default_idx); // borrowed
+            if (PyDict_SetItem(self->sig_types, name_obj, (PyObject*)Py_TYPE(default_val)) < 0) {
+                return -1;
             }
+        }
+    }
 
-            /* Prefer Finding parameter type from type-hint. */
-            if (annotations && PyDict_Check(annotations)) {
-                PyObject *hint = typecast_future_typehint(PyDict_GetItem(annotations, name_obj));
+    return 0;
+}
 
-                if (!hint) {
-                    return -2;
-                }
+/**
+ * @brief Parse positional and named slash arguments, supporting short options if enabled.
+ *
+ * Arguments are converted to their type-hinted types, using the signature cached by `PythonSlashCommand_build_signature()`.
+ *
+ * @param self PythonSlashCommandObject containing the Python function and short_opts flag
+ * @param slash Slash context
+ * @param args_out Output tuple for positional args
+ * @param kwargs_out Output dict for keyword args
+ * @return int 0 on success, -1 on error
+ */
+int pycsh_parse_slash_args(PythonSlashCommandObject *self, const struct slash *slash, PyObject **args_out, PyObject **kwargs_out) {
+    PyObject *py_func = self->py_slash_func;
+    const bool short_opts = self->short_opts;
 
-                if (PyType_Check(hint)) {
-                    PyDict_SetItem(param_type_dict, name_obj, hint);
-                    param_type_map[(unsigned char)name[0]] = (PyTypeObject*)hint;
-                } else {  /* No type-hint, defer to type of default. */
-                    PyObject *defaults AUTO_DECREF = PyObject_GetAttrString(py_func, "__defaults__");
-                    if (defaults && PyTuple_Check(defaults)) {
-                        Py_ssize_t num_defaults = PyTuple_Size(defaults);
-                        Py_ssize_t default_idx = i - (co_argcount - num_defaults);
-                        if (default_idx >= 0 && default_idx < num_defaults) {
-                            PyObject *default_val = PyTuple_GetItem(defaults, default_idx); // borrowed
-                            PyDict_SetItem(param_type_dict, name_obj, (PyObject*)default_val->ob_type);
-                            param_type_map[(unsigned char)name[0]] = default_val->ob_type;
-                        }
-                    }
-                }
-            }
+    /* Invalidate the cached signature if the code of the function has been replaced behind our back. */
+    if (self->sig_code == NULL || (PyFunction_Check(py_func) && PyFunction_GET_CODE(py_func) != self->sig_code)) {
+        if (PythonSlashCommand_build_signature(self) < 0) {
+            return -1;
         }
     }
 
+    PyObject *varnames = self->sig_varnames;
+    PyObject *param_type_dict = self->sig_types;
+
     /* Now actually parse the values. */
     PyObject* args_tuple AUTO_DECREF = PyTuple_New(slash->argc < 0 ? 0 : slash->argc);
     PyObject* kwargs_dict AUTO_DECREF = PyDict_New();
@@ -207,33 +241,34 @@ int pycsh_parse_slash_args(PythonSlashCommandObject *self, const struct slash *s
         const char* arg = slash->argv[i];
         if (short_opts && strncmp(arg, "-", 1) == 0 && strncmp(arg, "--", 2) != 0 && strlen(arg) >= 2) {
             // Single dash, short option
-            unsigned char first = (unsigned char)arg[1];
-            if (param_name_map[first]) {
+            const uint8_t short_index = self->sig_short[(unsigned char)arg[1]];
+            if (short_index) {
 
+                PyObject *param_name = PyTuple_GET_ITEM(varnames, short_index - 1);  // borrowed
                 const char *eq = strchr(arg, '=');
                 PyObject *py_value AUTO_DECREF = NULL;
-                PyTypeObject *param_type = param_type_map[first];
+                PyTypeObject *param_type = (PyTypeObject*)PyDict_GetItem(param_type_dict, param_name);  // borrowed
                 if (eq) {
                     /* Value specified with equal sign */
                     PyObject * _py_str_arg AUTO_DECREF = PyUnicode_FromString(eq + 1);
-                    assert(param_name_map[first]);
-                    py_value = typecast_to_hinted_type((PyObject*)param_type, _py_str_arg, py_func, param_name_map[first]);
-                    if (!py_value) {
-                        return -1;
-                    }
+                    py_value = typecast_to_hinted_type((PyObject*)param_type, _py_str_arg, py_func, param_name);
                 } else if (param_type && PyType_IsSubtype(param_type, &PyBool_Type)) {
                     /* Disallow boolean short-opt values to be space separated,
                         to prevent ambiguity with flags. */
                     py_value = Py_NewRef(Py_True);
                 } else if (i + 1 < slash->argc) {
                     /* Non-bool short opts: allow value */
-                    py_value = PyUnicode_FromString(slash->argv[++i]);
+                    PyObject * _py_str_arg AUTO_DECREF = PyUnicode_FromString(slash->argv[++i]);
+                    py_value = typecast_to_hinted_type((PyObject*)param_type, _py_str_arg, py_func, param_name);
+                } else {
+                    PyErr_Format(PyExc_ValueError, "Missing value for option '%s'", arg);
                 }
 
-                assert(py_value);
-                assert(param_name_map[first]);
+                if (!py_value) {
+                    return -1;
+                }
 
-                if (PyDict_SetItem(kwargs_dict, param_name_map[first], py_value) != 0) {
+                if (PyDict_SetItem(kwargs_dict, param_name, py_value) != 0) {
                     PyErr_SetString(PyExc_RuntimeError, "Failed to add short option to kwargs");
                     return -1;
                 }
@@ -245,11 +280,10 @@ int pycsh_parse_slash_args(PythonSlashCommandObject *self, const struct slash *s
 
             PyObject *_py_str_arg AUTO_DECREF = PyUnicode_FromString(arg);
 
-            assert(PyTuple_Check(co_varnames));
             assert(parsed_positional_args < slash->argc);
             /* There can be no type-hint if we've already parsed more arguments than the function has parameters.
                 We're not gonna do any type-checks for *args (at least for now), so we let Jesus take the wheel instead. */
-            if (parsed_positional_args >= PyTuple_GET_SIZE(co_varnames)) {
+            if (parsed_positional_args >= PyTuple_GET_SIZE(varnames)) {
                 /* We're passing a string here, which may not be what the user would want.
                     But we're most likely supplying an excess argument here, so calling the function will error.
                     We just want to let Python handle the error message. */
@@ -258,7 +292,7 @@ int pycsh_parse_slash_args(PythonSlashCommandObject *self, const struct slash *s
             }
 
             /* Token is not a keyword argument, simply add it as a positional argument to *args_out */
-            PyObject *param_name = PyTuple_GetItem(co_varnames, parsed_positional_args); // borrowed
+            PyObject *param_name = PyTuple_GET_ITEM(varnames, parsed_positional_args); // borrowed
 
             // TODO Kevin: Defer to default type
             PyObject *hint = PyDict_GetItem(param_type_dict, param_name); // borrowed
@@ -594,106 +628,6 @@ static char *format_python_func_help(PyObject *func, int only_print, bool short_
 }
 #endif
 
-typedef enum {
-    TYPECAST_SUCCESS = 0,
-    TYPECAST_UNSPECIFIED_EXCEPTION = -1,
-    TYPECAST_NO_ANNOTATION = -2,
-    TYPECAST_INVALID_ARG = -3,
-    TYPECAST_INVALID_KWARG = -4,
-} typecast_result_t;
-
-/**
- * @brief Inspect type-hints of the provided PyObject *func, and convert the arguments in py_args and py_kwargs (in-place) to the their corresponding type-hinted type.
- * 
- * Source: https://chatgpt.com
- * 
- * @param func Python function to call with py_args and py_kwargs.
- * @param py_args New tuple (without other references) that we can still modify in place.
- * @param py_kwargs Dictionary of arguments to modify in-place.
- * @return int 0 for success
- */
-static typecast_result_t SlashCommand_typecast_args(PyObject *python_func, PyObject *py_args, PyObject *py_kwargs) {
-
-    PyObject *annotations AUTO_DECREF = PyObject_GetAttrString(python_func, "__annotations__");
-    if (!annotations || !PyDict_Check(annotations)) {
-        // Handle error, no annotations found
-        // PyErr_SetString(PyExc_ValueError, "Failed to find annotations for function");
-        fprintf(stderr, "Failed to find annotations for Python function, no typehint argument conversion will be made");
-        return TYPECAST_NO_ANNOTATION;  // Or other appropriate error handling
-    }
-
-    {   /* handle *args */
-
-        // Get the parameter names from the function's code object
-        PyObject *code AUTO_DECREF = PyObject_GetAttrString(python_func, "__code__");
-        if (!code) {
-            assert(PyErr_Occurred());  // PyObject_GetAttrString() has probably raised an exception.
-            return TYPECAST_UNSPECIFIED_EXCEPTION;
-        }
-
-        PyObject *varnames AUTO_DECREF = PyObject_GetAttrString(code, "co_varnames");
-        if (!varnames || !PyTuple_Check(varnames)) {
-            assert(PyErr_Occurred());  // PyObject_GetAttrString() has probably raised an exception.
-            return TYPECAST_UNSPECIFIED_EXCEPTION;
-        }
-
-        Py_ssize_t num_args = PyTuple_Size(py_args);
-        for (Py_ssize_t i = 0; i < min(num_args, PyTuple_GET_SIZE(varnames)); i++) {
-            PyObject *arg = PyTuple_GetItem(py_args, i);  // Borrowed reference
-
-            // Get the corresponding parameter name for this positional argument
-            PyObject *param_name = PyTuple_GetItem(varnames, i);  // Borrowed reference
-            assert(param_name && PyUnicode_Check(param_name));
-
-            PyObject *hint = typecast_future_typehint(PyDict_GetItem(annotations, param_name));  // Borrowed reference
-            if (!hint) {
-                return TYPECAST_UNSPECIFIED_EXCEPTION;
-            }
-            PyObject *new_arg = typecast_to_hinted_type(hint, arg, python_func, param_name);  // No Py_DecRef(), as PyTuple_SetItem() will steal the reference.
-
-            if (!new_arg) {
-                assert(PyErr_Occurred());
-                return TYPECAST_UNSPECIFIED_EXCEPTION;
-            }
-
-            if (new_arg) {
-                // Replace the item in the tuple, stealing the reference of new_arg
-                PyTuple_SetItem(py_args, i, new_arg);
-            }
-        }
-    }
-
-    {   /* Handle **kwargs */
-        PyObject *key = NULL, *value = NULL;
-        Py_ssize_t pos = 0;
-
-        while (PyDict_Next(py_kwargs, &pos, &key, &value)) {
-            PyObject *hint = typecast_future_typehint(PyDict_GetItem(annotations, key));  // Borrowed reference
-            if (PyErr_Occurred()) {
-                assert(!hint);
-                return TYPECAST_UNSPECIFIED_EXCEPTION;
-            }
-
-            assert(key && PyUnicode_Check(key));
-            PyObject *new_kwarg AUTO_DECREF = typecast_to_hinted_type(hint, value, python_func, key);
-
-            if (!new_kwarg) {
-                assert(PyErr_Occurred());
-                return TYPECAST_INVALID_KWARG;
-            }
-            
-            if (new_kwarg) {
-                // Replace the value in the dictionary
-                PyDict_SetItem(py_kwargs, key, new_kwarg);
-                new_kwarg = NULL;  // Set to NULL so that AUTO_DECREF doesn't decrement it
-            }
-        }
-    }
-
-    assert(!PyErr_Occurred());
-    return TYPECAST_SUCCESS;
-}
-
 /**
  * @brief Shared callback for all slash_commands wrapped by a Slash object instance.
  */
@@ -742,22 +676,14 @@ int SlashCommand_func(struct slash *slash, void *context) {
         }
     }
 
-    /* Create the arguments. */
+    /* Create the arguments, converted to their type-hinted types. */
     PyObject *py_args AUTO_DECREF = NULL;
     PyObject *py_kwargs AUTO_DECREF = NULL;
-    /* TODO Kevin: Stop doing type-conversions in `pycsh_parse_slash_args()`.
-        It's a bit tricky since booleans require special attention. */
     if (pycsh_parse_slash_args(self, slash, &py_args, &py_kwargs) != 0) {
         PyErr_Print();
         return SLASH_EINVAL;
     }
 
-    /* Convert to type-hinted types */
-    if (SlashCommand_typecast_args(python_func, py_args, py_kwargs) && PyErr_Occurred()) {
-        PyErr_Print();
-        return SLASH_EINVAL;
-    }
-
     
     /* Call the user provided Python function */
     PyObject * value AUTO_DECREF = PyObject_Call(python_func, py_args, py_kwargs);
@@ -873,7 +799,7 @@ int PythonSlashCommand_set_func(PythonSlashCommandObject *self, PyObject *value,
             Py_XDECREF(self->py_slash_func);
         }
         self->py_slash_func = Py_None;
-        return 0;
+        return PythonSlashCommand_build_signature(self);
     }
 
     /* We now know that 'value' is a new callable. */
@@ -886,7 +812,8 @@ int PythonSlashCommand_set_func(PythonSlashCommandObject *self, PyObject *value,
     Py_INCREF(value);
     self->py_slash_func = value;
 
-    return 0;
+    /* Replacing the function invalidates its cached signature. */
+    return PythonSlashCommand_build_signature(self);
 }
 
 static PyObject * PythonSlashCommand_get_keep_alive(PythonSlashCommandObject *self, void *closure) {
@@ -1042,6 +969,11 @@ static void PythonSlashCommand_dealloc(PythonSlashCommandObject *self) {
         Py_XDECREF(self->py_slash_func);
         self->py_slash_func = NULL;
     }
+    if (!_Py_IsFinalizing()) {
+        Py_CLEAR(self->sig_code);
+        Py_CLEAR(self->sig_varnames);
+        Py_CLEAR(self->sig_types);
+    }
 
     struct slash_command * existing = slash_list_find_name(self->command_heap.name);
     //PythonSlashCommandObject *py_slash_command = python_wraps_slash_command(existing);
@@ -1110,7 +1042,7 @@ PyTypeObject PythonSlashCommandType = {
     PyVarObject_HEAD_INIT(NULL, 0)
     .tp_name = "pycsh.PythonSlashCommand",
     .tp_doc = "Slash command created in Python.",
-    .tp_basicsize = sizeof(PythonSlashCommandType),
+    .tp_basicsize = sizeof(PythonSlashCommandObject),
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = PythonSlashCommand_new,
@@ -33,6 +33,12 @@ typedef struct {
         `def function(option: str, option2: str) -> None` <-- exception
         `def function(option: str, Option2: str) -> None` <-- permitted, as `option2` becomes `-O` */
     bool short_opts;
+
+    /* Signature of `py_slash_func`, cached by `PythonSlashCommand_set_func()` rather than inspected for every invocation. */
+    PyObject *sig_code;  // `__code__` the signature was built from, so we notice when it is replaced.
+    PyObject *sig_varnames;  // tuple[str] of the parameters of `py_slash_func`.
+    PyObject *sig_types;  // dict[str, type] to convert string arguments to, from type-hints or the type of defaults.
+    uint8_t sig_short[256];  // 1 + index into `sig_varnames`, by first letter of parameter name. 0 when there is none.
 } PythonSlashCommandObject;
 
 extern PyTypeObject PythonSlashCommandType;
@@ -16,6 +16,7 @@
 #include "python_slash_command.h"
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
+#include <pycsh/param_index.h>
 #include <pycsh/attr_malloc.h>
 
 
@@ -112,138 +113,183 @@ static long SlashCommand_hash(SlashCommandObject *self) {
     return (long)self->command;
 }
 
-// Source https://chatgpt.com
-static char* _tuple_to_slash_string(const char * command_name, PyObject* args, PyObject* kwargs) {
-
-	// Check if args is a tuple
-    if (!PyTuple_Check(args)) {
-        PyErr_SetString(PyExc_TypeError, "First argument is not a tuple");
-        return NULL;
-    }
-
-    // Get the length of the tuple
-    Py_ssize_t size = PyTuple_Size(args);
-    if (size < 0) {
-        // Error occurred while getting tuple size
-        return NULL;
-    }
-
-    // Create an empty Unicode object
-    PyObject* unicode_result AUTO_DECREF = NULL;
-	if (command_name == NULL) {
-		unicode_result = PyUnicode_New(0, 0);
-	} else {
-		unicode_result = PyUnicode_FromString(command_name);
+/**
+ * @brief Arguments for a slash command, built directly from Python objects.
+ *
+ * `argv` and the strings it points to share a single allocation,
+ * so there is no limit on the number or length of arguments.
+ */
+typedef struct {
+	int argc;
+	char ** argv;
+	/* Arguments joined by spaces, only used for the execute hooks (i.e history/logging). */
+	char * line;
+} slash_argv_t;
+
+static void slash_argv_free(slash_argv_t * args) {
+	PyMem_Free(args->argv);
+}
+
+/* Append an argument, built from `prefix` + `key` + `sep` + `value` (any may be NULL), to the arena at `*cursor`. */
+static void slash_argv_append(slash_argv_t * args, char ** cursor, const char * prefix, const char * key, Py_ssize_t key_len, const char * sep, const char * value, Py_ssize_t value_len) {
+	char * const arg = *cursor;
+	char * out = arg;
+	if (prefix) {
+		out = stpcpy(out, prefix);
 	}
+	if (key) {
+		memcpy(out, key, key_len);
+		out += key_len;
+	}
+	if (sep) {
+		out = stpcpy(out, sep);
+	}
+	if (value) {
+		memcpy(out, value, value_len);
+		out += value_len;
+	}
+	*out++ = '\0';
+	*cursor = out;
+	args->argv[args->argc++] = arg;
+}
 
-    if (unicode_result == NULL) {
-        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
-        return NULL;
-    }
-
-    // Append keyword arguments to the Unicode object
-    if (kwargs != NULL && PyDict_Check(kwargs)) {
-        PyObject *key, *value;
-        Py_ssize_t pos = 0;
-
-        while (PyDict_Next(kwargs, &pos, &key, &value)) {
-            // Format each key-value pair as named arguments to shell commands
-            PyObject* str_key AUTO_DECREF = PyObject_Str(key);
-            PyObject* str_value AUTO_DECREF = PyObject_Str(value);
-            if (str_key == NULL || str_value == NULL) {
-                PyErr_SetString(PyExc_RuntimeError, "Failed to convert key-value pair to string");
-                return NULL;
-            }
-
-            // Append to the Unicode object
-            PyUnicode_AppendAndDel(&unicode_result, PyUnicode_FromString(" --"));
-            PyUnicode_AppendAndDel(&unicode_result, str_key);
-            /* Assume that boolean arguments are just flags without values,
-                i.e "--override" for ident */
-            if (!PyBool_Check(value)) {
-                PyUnicode_AppendAndDel(&unicode_result, PyUnicode_FromString("="));
-                PyUnicode_AppendAndDel(&unicode_result, str_value);
-            }
-        }
-    }
-
-    // Append positional arguments to the Unicode object
-    for (Py_ssize_t i = 0; i < size; ++i) {
-        // Get the i-th element of the tuple
-        PyObject* item = PyTuple_GetItem(args, i);
-        if (item == NULL) {
-            // Error occurred while getting tuple item
-            return NULL;
-        }
-
-        // Convert the element to a string
-        PyObject* str_obj = PyObject_Str(item);
-        if (str_obj == NULL) {
-            // Error occurred while converting to string
-            return NULL;
-        }
-
-        // Separate each argument with space
-        PyUnicode_AppendAndDel(&unicode_result, PyUnicode_FromString(" "));
-
-        // Append the string to the Unicode object
-        PyUnicode_AppendAndDel(&unicode_result, str_obj);
-    }
-
-    // Convert Unicode object to UTF-8 string
-    const char* temp = PyUnicode_AsUTF8(unicode_result);
-    if (temp == NULL) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to convert Unicode to UTF-8");
-		return NULL;
-    }
+/**
+ * @brief Build `argv` for `command_name` from Python arguments.
+ *
+ * Keyword arguments become "--key=value", or "--key" for `True` (and are omitted for `False`).
+ * Positional arguments follow, as `str()` of each.
+ *
+ * @return 0 on success, -1 with an exception set.
+ */
+static int slash_argv_from_python(slash_argv_t * out, const char * command_name, PyObject * args, PyObject * kwargs) {
 
-	char *result = malloc(strlen(temp)+1);
-	if (result == NULL) {
-		PyErr_NoMemory();
-		return NULL;
+	assert(PyTuple_Check(args));
+	const Py_ssize_t nargs = PyTuple_GET_SIZE(args);
+	const Py_ssize_t nkwargs = (kwargs != NULL) ? PyDict_GET_SIZE(kwargs) : 0;
+
+	/* Hold the `str()` of every key and value until they have been copied to the arena. */
+	PyObject * strs AUTO_DECREF = PyTuple_New(2 * nkwargs + nargs);
+	if (strs == NULL) {
+		return -1;
 	}
-	strcpy(result, temp);
 
-    return result;
-}
+	const size_t name_len = strlen(command_name);
+	size_t arena_len = name_len + 1;
+
+	Py_ssize_t nstrs = 0;
+	if (kwargs != NULL) {
+		PyObject *key, *value;
+		Py_ssize_t pos = 0;
+		while (PyDict_Next(kwargs, &pos, &key, &value)) {
+			PyObject * const str_key = PyObject_Str(key);
+			PyObject * const str_value = PyBool_Check(value) ? Py_NewRef(value) : PyObject_Str(value);
+			if (str_key == NULL || str_value == NULL) {
+				Py_XDECREF(str_key);
+				Py_XDECREF(str_value);
+				return -1;
+			}
+			PyTuple_SET_ITEM(strs, nstrs++, str_key);
+			PyTuple_SET_ITEM(strs, nstrs++, str_value);
+
+			Py_ssize_t len;
+			if (PyUnicode_AsUTF8AndSize(str_key, &len) == NULL) {
+				return -1;
+			}
+			arena_len += len + sizeof("--=");
+			if (!PyBool_Check(str_value)) {
+				if (PyUnicode_AsUTF8AndSize(str_value, &len) == NULL) {
+					return -1;
+				}
+				arena_len += len;
+			}
+		}
+	}
+
+	for (Py_ssize_t i = 0; i < nargs; i++) {
+		PyObject * const str_arg = PyObject_Str(PyTuple_GET_ITEM(args, i));
+		if (str_arg == NULL) {
+			return -1;
+		}
+		PyTuple_SET_ITEM(strs, nstrs++, str_arg);
+
+		Py_ssize_t len;
+		if (PyUnicode_AsUTF8AndSize(str_arg, &len) == NULL) {
+			return -1;
+		}
+		arena_len += len + 1;
+	}
+
+	/* One allocation for: argv[argc + 1], the arguments, and the joined line (no longer than the arguments). */
+	const size_t argv_len = (1 + nkwargs + nargs + 1) * sizeof(char *);
+	char ** const argv = PyMem_Malloc(argv_len + 2 * arena_len);
+	if (argv == NULL) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	*out = (slash_argv_t){.argc = 0, .argv = argv};
+
+	char * cursor = (char *)argv + argv_len;
+	slash_argv_append(out, &cursor, NULL, command_name, name_len, NULL, NULL, 0);
+
+	for (Py_ssize_t i = 0; i < 2 * nkwargs; i += 2) {
+		PyObject * const str_key = PyTuple_GET_ITEM(strs, i);
+		PyObject * const str_value = PyTuple_GET_ITEM(strs, i + 1);
+		Py_ssize_t key_len, value_len;
+		const char * const key = PyUnicode_AsUTF8AndSize(str_key, &key_len);
+		if (str_value == Py_False) {
+			continue;
+		} else if (str_value == Py_True) {
+			/* Assume that boolean arguments are just flags without values,
+				i.e "--override" for ident */
+			slash_argv_append(out, &cursor, "--", key, key_len, NULL, NULL, 0);
+		} else {
+			const char * const value = PyUnicode_AsUTF8AndSize(str_value, &value_len);
+			slash_argv_append(out, &cursor, "--", key, key_len, "=", value, value_len);
+		}
+	}
 
+	for (Py_ssize_t i = 2 * nkwargs; i < nstrs; i++) {
+		Py_ssize_t len;
+		const char * const arg = PyUnicode_AsUTF8AndSize(PyTuple_GET_ITEM(strs, i), &len);
+		slash_argv_append(out, &cursor, NULL, arg, len, NULL, NULL, 0);
+	}
+	argv[out->argc] = NULL;
+
+	/* The arguments are NUL separated in the arena, so the line is just a copy with spaces instead. */
+	out->line = cursor;
+	const size_t used = cursor - ((char *)argv + argv_len);
+	memcpy(out->line, (char *)argv + argv_len, used);
+	for (size_t i = 0; i + 1 < used; i++) {
+		if (out->line[i] == '\0') {
+			out->line[i] = ' ';
+		}
+	}
 
+	return 0;
+}
 
 static PyObject * SlashCommand_call(SlashCommandObject *self, PyObject *args, PyObject *kwds) {
 
 	assert(self->command);  // It is invalid for SlashCommandObject to exist without wrapping a slash command
 	assert(self->command->context);
-	char *line CLEANUP_STR = _tuple_to_slash_string(self->command->name, args, kwds);
 
-	if (line == NULL) {
-		//PyErr_SetString(PyExc_ValueError, "Failed to convert arguments to slash string");
+	slash_argv_t slash_argv __attribute__((cleanup(slash_argv_free))) = {0};
+	if (slash_argv_from_python(&slash_argv, self->command->name, args, kwds) < 0) {
 		return NULL;
 	}
 
 	/* Configuration */
-	#define SLASH_ARG_MAX		16	/* Maximum number of arguments */
-	#define SLASH_SHOW_MAX		25	/* Maximum number of commands to list */
     #define LINE_SIZE		    512
     #define HISTORY_SIZE		2048
 
+	/* The line buffer is only used by commands that read input, our arguments don't live here. */
 	struct slash slas = {0};
+	char line_buf[LINE_SIZE];
     char hist_buf[HISTORY_SIZE];
-    slash_create_static(&slas, line, LINE_SIZE, hist_buf, HISTORY_SIZE);
-	
+    slash_create_static(&slas, line_buf, LINE_SIZE, hist_buf, HISTORY_SIZE);
 
 	/* Implement this function to perform logging for example */
-	slash_on_execute_hook(line);
-
-	char *slash_args = line+strnlen(self->command->name, LINE_MAX), *argv[SLASH_ARG_MAX];
-	int argc = 0;
-
-	/* Build args */
-	extern int slash_build_args(char *args, char **argv, int *argc);
-	if (slash_build_args(slash_args, argv, &argc) < 0) {
-		slash_printf(&slas, "Mismatched quotes\n");
-		// TODO Kevin: Probably raise exception here?
-		return Py_BuildValue("i", -EINVAL);
-	}
+	slash_on_execute_hook(slash_argv.line);
 
 	/* Reset state for slash_getopt */
 	slas.optarg = 0;
@@ -252,8 +298,8 @@ static PyObject * SlashCommand_call(SlashCommandObject *self, PyObject *args, Py
 	slas.optopt = '?';
 	slas.sp = 1;
 
-	slas.argc = argc;
-	slas.argv = argv;
+	slas.argc = slash_argv.argc;
+	slas.argv = slash_argv.argv;
 
 	int ret = self->command->func_ctx(&slas, self->command->context);
 
@@ -261,7 +307,10 @@ static PyObject * SlashCommand_call(SlashCommandObject *self, PyObject *args, Py
 	if (ret == SLASH_EUSAGE)
 		slash_command_usage(&slas, self->command);
 
-	slash_on_execute_post_hook(line, self->command);
+	slash_on_execute_post_hook(slash_argv.line, self->command);
+
+	/* Commands like "list forget" and "list download" modify the parameter list behind our back. */
+	pycsh_param_index_invalidate();
 
 	return Py_BuildValue("i", ret);
 }
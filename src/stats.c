@@ -0,0 +1,279 @@
+/*
+ * stats.c
+ *
+ * Always-on per-node transaction counters and latency histograms.
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: Kevin Wallentin Carlsen
+ */
+
+#include <pycsh/stats.h>
+
+#include <time.h>
+#include <assert.h>
+#include <stdatomic.h>
+
+#include <pycsh/utils.h>
+
+/* Nodes beyond this many distinct addresses share the overflow entry (reported as node -1). */
+#define PYCSH_STATS_MAX_NODES 256
+
+/* Lower bound of adaptive timeouts, covers scheduling jitter of nodes which usually reply within microseconds. */
+#define PYCSH_RTO_MIN_MS 50
+
+typedef struct {
+	_Atomic uint64_t requests;
+	_Atomic uint64_t timeouts;
+	_Atomic uint64_t retries;
+	_Atomic uint64_t tx_bytes;
+	_Atomic uint64_t rx_bytes;
+	_Atomic uint64_t latency_us_total;
+	_Atomic uint64_t latency_hist[PYCSH_STATS_HIST_BUCKETS];
+} pycsh_kind_stats_t;
+
+typedef struct {
+	/* node+1 of the entry, 0 while unclaimed. */
+	_Atomic int node_plus_one;
+	pycsh_kind_stats_t kinds[PYCSH_STATS_KIND_COUNT];
+	/* Smoothed round-trip time in the upper 32 bits, and its variation in the lower, both in microseconds.
+		Packed so they are always updated together. 0 until the first reply. */
+	_Atomic uint64_t rtt;
+} pycsh_node_stats_t;
+
+static pycsh_node_stats_t node_stats[PYCSH_STATS_MAX_NODES];
+static pycsh_node_stats_t overflow_stats = {.node_plus_one = 0};
+
+static _Thread_local uint32_t thread_rx_bytes = 0;
+
+static const char * const kind_names[PYCSH_STATS_KIND_COUNT] = {
+	[PYCSH_STATS_PULL] = "pull",
+	[PYCSH_STATS_PUSH] = "push",
+	[PYCSH_STATS_PULL_ALL] = "pull_all",
+	[PYCSH_STATS_VMEM] = "vmem",
+	[PYCSH_STATS_CALLBACK] = "callback",
+};
+
+uint64_t pycsh_stats_now_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Find or claim the entry for `node`, linear probing from its hash. */
+static pycsh_node_stats_t * node_stats_get(int node, bool claim) {
+
+	const int key = node + 1;
+	const unsigned int start = (unsigned int)node % PYCSH_STATS_MAX_NODES;
+
+	for (unsigned int i = 0; i < PYCSH_STATS_MAX_NODES; i++) {
+		pycsh_node_stats_t * entry = &node_stats[(start + i) % PYCSH_STATS_MAX_NODES];
+		int current = atomic_load_explicit(&entry->node_plus_one, memory_order_acquire);
+		if (current == key) {
+			return entry;
+		}
+		if (current == 0) {
+			if (!claim) {
+				return NULL;
+			}
+			int expected = 0;
+			if (atomic_compare_exchange_strong(&entry->node_plus_one, &expected, key) || expected == key) {
+				return entry;
+			}
+			/* Another thread claimed this slot for a different node, keep probing. */
+		}
+	}
+
+	return claim ? &overflow_stats : NULL;
+}
+
+static unsigned int latency_bucket(uint64_t latency_us) {
+	const unsigned int bucket = 63 - __builtin_clzll(latency_us | 1);
+	return bucket < PYCSH_STATS_HIST_BUCKETS ? bucket : PYCSH_STATS_HIST_BUCKETS-1;
+}
+
+/* RFC 6298 estimator */
+void pycsh_stats_rtt_sample(int node, uint64_t sample_us) {
+
+	pycsh_node_stats_t * const entry = node_stats_get(node, true);
+	const uint32_t r = sample_us < UINT32_MAX ? sample_us : UINT32_MAX;
+	uint64_t current = atomic_load_explicit(&entry->rtt, memory_order_relaxed);
+	uint64_t next;
+	do {
+		uint32_t srtt = current >> 32;
+		uint32_t rttvar = current & UINT32_MAX;
+		if (current == 0) {
+			srtt = r;
+			rttvar = r / 2;
+		} else {
+			const uint32_t delta = srtt > r ? srtt - r : r - srtt;
+			rttvar = rttvar - rttvar / 4 + delta / 4;
+			srtt = srtt - srtt / 8 + r / 8;
+		}
+		next = ((uint64_t)(srtt | 1) << 32) | rttvar;  // Never 0 once sampled.
+	} while (!atomic_compare_exchange_weak_explicit(&entry->rtt, &current, next, memory_order_relaxed, memory_order_relaxed));
+}
+
+void pycsh_stats_record(int node, pycsh_stats_kind_e kind, uint64_t start_us, bool timed_out, uint32_t tx_bytes, uint32_t rx_bytes) {
+
+	assert(kind < PYCSH_STATS_KIND_COUNT);
+	pycsh_kind_stats_t * stats = &node_stats_get(node, true)->kinds[kind];
+	const uint64_t latency_us = pycsh_stats_now_us() - start_us;
+
+	atomic_fetch_add_explicit(&stats->requests, 1, memory_order_relaxed);
+	if (timed_out) {
+		atomic_fetch_add_explicit(&stats->timeouts, 1, memory_order_relaxed);
+	}
+	atomic_fetch_add_explicit(&stats->tx_bytes, tx_bytes, memory_order_relaxed);
+	atomic_fetch_add_explicit(&stats->rx_bytes, rx_bytes, memory_order_relaxed);
+	atomic_fetch_add_explicit(&stats->latency_us_total, latency_us, memory_order_relaxed);
+	atomic_fetch_add_explicit(&stats->latency_hist[latency_bucket(latency_us)], 1, memory_order_relaxed);
+}
+
+int pycsh_stats_timeout(int node, int attempt, int fallback_ms) {
+
+	int rto_ms = fallback_ms;
+
+	const pycsh_node_stats_t * entry = node_stats_get(node, false);
+	const uint64_t rtt = entry ? atomic_load_explicit(&entry->rtt, memory_order_relaxed) : 0;
+	if (rtt != 0) {
+		const uint64_t rto_us = (rtt >> 32) + 4 * (rtt & UINT32_MAX);
+		rto_ms = rto_us / 1000 + 1;
+		if (rto_ms < PYCSH_RTO_MIN_MS) {
+			rto_ms = PYCSH_RTO_MIN_MS;
+		}
+		if (rto_ms > fallback_ms) {
+			rto_ms = fallback_ms;
+		}
+	}
+
+	/* Exponential backoff for retries, up to `fallback_ms` */
+	for (int i = 0; i < attempt && rto_ms < fallback_ms; i++) {
+		rto_ms = (rto_ms < fallback_ms / 2) ? rto_ms * 2 : fallback_ms;
+	}
+	return rto_ms;
+}
+
+int pycsh_stats_resolve_timeout(int timeout, int node, int attempt, int fallback_ms) {
+	return (timeout == PYCSH_TIMEOUT_AUTO) ? pycsh_stats_timeout(node, attempt, fallback_ms) : timeout;
+}
+
+void pycsh_stats_retry(int node, pycsh_stats_kind_e kind) {
+	assert(kind < PYCSH_STATS_KIND_COUNT);
+	atomic_fetch_add_explicit(&node_stats_get(node, true)->kinds[kind].retries, 1, memory_order_relaxed);
+}
+
+void pycsh_stats_rx_bytes(uint32_t rx_bytes) {
+	thread_rx_bytes += rx_bytes;
+}
+
+uint32_t pycsh_stats_rx_bytes_take(void) {
+	const uint32_t rx_bytes = thread_rx_bytes;
+	thread_rx_bytes = 0;
+	return rx_bytes;
+}
+
+/* Read (and optionally reset) a counter, without losing concurrent increments. */
+static uint64_t counter_read(_Atomic uint64_t * counter, bool reset) {
+	if (reset) {
+		return atomic_exchange_explicit(counter, 0, memory_order_relaxed);
+	}
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static PyObject * kind_stats_to_dict(pycsh_kind_stats_t * stats, bool reset) {
+
+	PyObject * hist AUTO_DECREF = PyTuple_New(PYCSH_STATS_HIST_BUCKETS);
+	if (hist == NULL) {
+		return NULL;
+	}
+	for (int i = 0; i < PYCSH_STATS_HIST_BUCKETS; i++) {
+		PyObject * count = PyLong_FromUnsignedLongLong(counter_read(&stats->latency_hist[i], reset));
+		if (count == NULL) {
+			return NULL;
+		}
+		PyTuple_SET_ITEM(hist, i, count);
+	}
+
+	return Py_BuildValue("{s:K,s:K,s:K,s:K,s:K,s:K,s:O}",
+		"requests", (unsigned long long)counter_read(&stats->requests, reset),
+		"timeouts", (unsigned long long)counter_read(&stats->timeouts, reset),
+		"retries", (unsigned long long)counter_read(&stats->retries, reset),
+		"tx_bytes", (unsigned long long)counter_read(&stats->tx_bytes, reset),
+		"rx_bytes", (unsigned long long)counter_read(&stats->rx_bytes, reset),
+		"latency_us_total", (unsigned long long)counter_read(&stats->latency_us_total, reset),
+		"latency_hist", hist
+	);
+}
+
+static int node_stats_to_dict(PyObject * out, int node, pycsh_node_stats_t * entry, bool reset) {
+
+	PyObject * kinds AUTO_DECREF = PyDict_New();
+	if (kinds == NULL) {
+		return -1;
+	}
+
+	for (int kind = 0; kind < PYCSH_STATS_KIND_COUNT; kind++) {
+		PyObject * kind_dict AUTO_DECREF = kind_stats_to_dict(&entry->kinds[kind], reset);
+		if (kind_dict == NULL || PyDict_SetItemString(kinds, kind_names[kind], kind_dict) < 0) {
+			return -1;
+		}
+	}
+
+	PyObject * key AUTO_DECREF = PyLong_FromLong(node);
+	if (key == NULL) {
+		return -1;
+	}
+	return PyDict_SetItem(out, key, kinds);
+}
+
+PyObject * pycsh_stats(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	PyObject * node_obj = Py_None;
+	int reset = 0;
+
+	static char *kwlist[] = {"node", "reset", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op:stats", kwlist, &node_obj, &reset))
+		return NULL;  // TypeError is thrown
+
+	PyObject * out AUTO_DECREF = PyDict_New();
+	if (out == NULL) {
+		return NULL;
+	}
+
+	if (node_obj != Py_None) {
+		const int node = PyLong_AsLong(node_obj);
+		if (PyErr_Occurred()) {
+			return NULL;
+		}
+		pycsh_node_stats_t * entry = node_stats_get(node, false);
+		if (entry != NULL && node_stats_to_dict(out, node, entry, reset) < 0) {
+			return NULL;
+		}
+		return Py_NewRef(out);
+	}
+
+	for (int i = 0; i < PYCSH_STATS_MAX_NODES; i++) {
+		const int node_plus_one = atomic_load_explicit(&node_stats[i].node_plus_one, memory_order_acquire);
+		if (node_plus_one == 0) {
+			continue;
+		}
+		if (node_stats_to_dict(out, node_plus_one-1, &node_stats[i], reset) < 0) {
+			return NULL;
+		}
+	}
+
+	/* Only report the overflow entry once it has actually been used. */
+	if (atomic_load_explicit(&overflow_stats.kinds[PYCSH_STATS_PULL].requests, memory_order_relaxed) ||
+		atomic_load_explicit(&overflow_stats.kinds[PYCSH_STATS_PUSH].requests, memory_order_relaxed) ||
+		atomic_load_explicit(&overflow_stats.kinds[PYCSH_STATS_PULL_ALL].requests, memory_order_relaxed) ||
+		atomic_load_explicit(&overflow_stats.kinds[PYCSH_STATS_VMEM].requests, memory_order_relaxed) ||
+		atomic_load_explicit(&overflow_stats.kinds[PYCSH_STATS_CALLBACK].requests, memory_order_relaxed)) {
+		if (node_stats_to_dict(out, -1, &overflow_stats, reset) < 0) {
+			return NULL;
+		}
+	}
+
+	return Py_NewRef(out);
+}
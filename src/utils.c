@@ -10,6 +10,7 @@
 #include <pycsh/utils.h>
 
 #include <dirent.h>
+#include <pthread.h>
 #include <apm/csh_api.h>
 #include <csp/csp_hooks.h>
 #include <csp/csp_buffer.h>
@@ -21,6 +22,11 @@
 #include <pycsh/pycsh.h>
 #include <pycsh/parameter.h>
 #include <pycsh/attr_malloc.h>
+#include <pycsh/stats.h>
+#include <pycsh/param_index.h>
+#include <pycsh/watch.h>
+#include <pycsh/history.h>
+#include <pycsh/batch.h>
 #include "parameter/parameterlist.h"
 
 #undef NDEBUG
@@ -277,9 +283,13 @@ const param_t * _pycsh_util_find_param_t(PyObject * param_identifier, int node)
 	const param_t * param = NULL;
 
 	if (PyUnicode_Check(param_identifier)) {  // is_string
-		param = param_list_find_name(node, (char*)PyUnicode_AsUTF8(param_identifier));
+		const char * const name = PyUnicode_AsUTF8(param_identifier);
+		if (name == NULL) {
+			return NULL;
+		}
+		param = pycsh_param_index_find_name(node, name);
 	} else if (PyLong_Check(param_identifier)) {  // is_int
-		param = param_list_find_id(node, (int)PyLong_AsLong(param_identifier));
+		param = pycsh_param_index_find_id(node, (int)PyLong_AsLong(param_identifier));
 	} else if (PyObject_TypeCheck(param_identifier, &ParameterType)) {
 		param = ((ParameterObject *)param_identifier)->param;
 	} else {  // Invalid type passed.
@@ -428,6 +438,31 @@ ParameterObject * Parameter_wraps_param(const param_t *param) {
 	return python_param;
 }
 
+void pycsh_glob_compile(pycsh_glob_t * glob, const char * pattern) {
+	*glob = (pycsh_glob_t){.pattern = pattern};
+	if (pattern == NULL || strcmp(pattern, "*") == 0) {
+		glob->match_all = true;
+		return;
+	}
+	glob->len = strlen(pattern);
+	glob->prefix_len = strcspn(pattern, "*?[");
+	glob->has_wildcard = glob->prefix_len < glob->len;
+}
+
+bool pycsh_glob_match(const pycsh_glob_t * glob, const char * name) {
+	if (glob->match_all) {
+		return true;
+	}
+	if (!glob->has_wildcard) {
+		return strcmp(name, glob->pattern) == 0;
+	}
+	if (strncmp(name, glob->pattern, glob->prefix_len) != 0) {
+		return false;
+	}
+	int strmatch(const char *str, const char *pattern, int n, int m);  // TODO Kevin: Maybe strmatch() should be in the libparam public API?
+	return strmatch(name, glob->pattern, strlen(name), glob->len) != 0;
+}
+
 /**
  * @brief Return a list of Parameter wrappers similar to the "list" slash command
  * 
@@ -436,11 +471,34 @@ ParameterObject * Parameter_wraps_param(const param_t *param) {
  */
 PyObject * pycsh_util_parameter_list(uint32_t mask, int node, const char * globstr) {
 
-	PyObject * list = PyObject_CallObject((PyObject *)&ParameterListType, NULL);
+	pycsh_glob_t glob;
+	pycsh_glob_compile(&glob, globstr);
 
+	/* Count matches first, so the result can be allocated once. */
+	Py_ssize_t count = 0;
 	const param_t * param;
 	param_list_iterator i = {0};
 	while ((param = param_list_iterate(&i)) != NULL) {
+		if ((node >= 0) && (*param->node != node)) {
+			continue;
+		}
+		if ((param->mask & mask) == 0) {
+			continue;
+		}
+		if (!pycsh_glob_match(&glob, param->name)) {
+			continue;
+		}
+		count++;
+	}
+
+	PyObject * items AUTO_DECREF = PyList_New(count);
+	if (items == NULL) {
+		return NULL;
+	}
+
+	Py_ssize_t filled = 0;
+	i = (param_list_iterator){0};
+	while ((param = param_list_iterate(&i)) != NULL && filled < count) {
 
 		if ((node >= 0) && (*param->node != node)) {
 			continue;
@@ -448,23 +506,36 @@ PyObject * pycsh_util_parameter_list(uint32_t mask, int node, const char * globs
 		if ((param->mask & mask) == 0) {
 			continue;
 		}
-		int strmatch(const char *str, const char *pattern, int n, int m);  // TODO Kevin: Maybe strmatch() should be in the libparam public API?
-		if ((globstr != NULL) && strmatch(param->name, globstr, strlen(param->name), strlen(globstr)) == 0) {
+		if (!pycsh_glob_match(&glob, param->name)) {
 			continue;
 		}
 
 		/* CSH does not specify a paramver when listing parameters,
 			so we just use 2 as the default version for the created instances. */
-		PyObject * parameter AUTO_DECREF = pycsh_Parameter_from_param(&ParameterType, param, NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
+		PyObject * parameter = pycsh_Parameter_from_param(&ParameterType, param, NULL, INT_MIN, pycsh_dfl_timeout, 1, 2, PY_PARAM_FREE_NO);
 		if (parameter == NULL) {
-			Py_DECREF(list);
 			return NULL;
 		}
-		PyObject * argtuple AUTO_DECREF = PyTuple_Pack(1, parameter);
-		Py_XDECREF(ParameterList_append(list, argtuple));  // TODO Kevin: DECREF on None doesn't seem right here...
+		PyList_SET_ITEM(items, filled++, parameter);  // Steals reference
 	}
 
-	return list;
+	/* The Python callbacks of `pycsh_Parameter_from_param()` should not be able to shrink the list,
+		but don't hand out NULL items if it happens anyway. */
+	if (filled < count && PyList_SetSlice(items, filled, count, NULL) < 0) {
+		return NULL;
+	}
+
+	PyObject * list AUTO_DECREF = PyObject_CallObject((PyObject *)&ParameterListType, NULL);
+	if (list == NULL) {
+		return NULL;
+	}
+
+	/* Single resize and copy, rather than `ParameterList_append()` per element. */
+	if (PyList_SetSlice(list, 0, 0, items) < 0) {
+		return NULL;
+	}
+
+	return Py_NewRef(list);
 
 }
 
@@ -473,6 +544,39 @@ typedef struct param_list_s {
 	const param_t ** param_arr;
 } param_list_t;
 
+/* `param->timestamp` is updated by any offset, so array parameters are only considered fresh
+	from the last time all of their elements were received, which is recorded here.
+	Direct-mapped by address, so a colliding parameter only causes an extra pull. */
+#define PARAM_WHOLE_SLOTS 1024
+typedef struct {
+	const param_t * param;
+	uint16_t node;
+	uint16_t id;
+	csp_timestamp_t timestamp;
+} param_whole_t;
+static param_whole_t param_whole[PARAM_WHOLE_SLOTS];
+static pthread_mutex_t param_whole_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static param_whole_t * param_whole_slot(const param_t * param) {
+	return &param_whole[((uintptr_t)param >> 4) % PARAM_WHOLE_SLOTS];
+}
+
+/* Call after `offset` of `param` has been applied, and its timestamp updated. */
+static void pycsh_param_whole_record(const param_t * param, int offset) {
+
+	if (param == NULL || offset >= 0 || param->array_size <= 1 || *param->node == 0) {
+		return;
+	}
+
+	pthread_mutex_lock(&param_whole_lock);
+	param_whole_t * const slot = param_whole_slot(param);
+	slot->param = param;
+	slot->node = *param->node;
+	slot->id = param->id;
+	slot->timestamp = *param->timestamp;
+	pthread_mutex_unlock(&param_whole_lock);
+}
+
 /* Do not apply parameters to the global list, only use the provided one */
 static void pycsh_param_queue_apply_listless(param_queue_t * queue, param_list_t * param_list, int from, bool skip_list) {
 
@@ -526,6 +630,18 @@ static void pycsh_param_queue_apply_listless(param_queue_t * queue, param_list_t
 
 			param_deserialize_from_mpack_to_param(NULL, NULL, param, offset, &reader);
 
+			/* Keep the timestamp current, like `param_queue_apply()` does for list parameters,
+				so `pycsh_param_is_fresh()` works for these too. */
+			if (*param->node != 0) {
+				if (timestamp.tv_sec == 0) {
+					csp_clock_get_time(&timestamp);
+				}
+				*param->timestamp = timestamp;
+			}
+			pycsh_param_whole_record(param, offset);
+
+			pycsh_history_record(param);
+
 			/* Print the local RAM copy of the remote parameter (which is not in the list) */
 			// if (verbose) {
 			// 	param_print(param, -1, NULL, 0, verbose, 0);
@@ -540,37 +656,6 @@ static void pycsh_param_queue_apply_listless(param_queue_t * queue, param_list_t
 	}
 }
 
-static void pycsh_param_transaction_callback_pull(csp_packet_t *response, int verbose, int version, void * context) {
-
-	int from = response->id.src;
-	//csp_hex_dump("pull response", response->data, response->length);
-	//printf("From %d\n", from);
-
-	assert(context != NULL);
-	param_list_t * param_list = (param_list_t *)context;
-
-	param_queue_t queue;
-	param_queue_init(&queue, &response->data[2], response->length - 2, response->length - 2, PARAM_QUEUE_TYPE_SET, version);
-	queue.last_node = response->id.src;
-
-	/* Even though we have been provided a `param_t * param`,
-		we still call `param_queue_apply()` to support replies which unexpectedly contain multiple parameters.
-		Although we are SOL if those unexpected parameters are not in the list.
-		TODO Kevin: Make sure ParameterList accounts for this scenario. */
-	param_queue_apply(&queue, from, verbose);
-
-	/* For now we tolerate possibly setting parameters twice,
-		as we have not had remote parameters with callbacks/side-effects yet.
-		Although it is possible, I have tested it.
-		We `assert()` that `pycsh_param_transaction_callback_pull()` is only used client-side.
-		So PyCSH parameter servers will only use `param_queue_apply()` to apply parameters,
-		meaning no worries about callbacks being set twice. */
-	pycsh_param_queue_apply_listless(&queue, param_list, from, true);
-
-	csp_buffer_free(response);
-}
-
-
 /**
  * @brief Check that the callback accepts exactly one Parameter and one integer,
  *  as specified by "void (*callback)(struct param_s * param, int offset)"
@@ -799,6 +884,9 @@ static int param_queue_apply_err_callback(param_queue_t *queue, int host, int ve
 			}
 
 			param_deserialize_from_mpack_to_param(NULL, queue, param, offset, &reader);
+			pycsh_param_whole_record(param, offset);
+			pycsh_watch_notify(param);
+			pycsh_history_record(param);
 		} else {
 			// We couldn't find all parameters. Skip this one.
 			return_code = -1;
@@ -911,11 +999,45 @@ static void pycsh_decode_err_callback(uint16_t node, uint16_t id, uint8_t debug_
 	//PyErr_Print();
 }
 
+static void pycsh_param_transaction_callback_pull(csp_packet_t *response, int verbose, int version, void * context) {
+
+	int from = response->id.src;
+	pycsh_stats_rx_bytes(response->length);
+	//csp_hex_dump("pull response", response->data, response->length);
+	//printf("From %d\n", from);
+
+	assert(context != NULL);
+	param_list_t * param_list = (param_list_t *)context;
+
+	param_queue_t queue;
+	param_queue_init(&queue, &response->data[2], response->length - 2, response->length - 2, PARAM_QUEUE_TYPE_SET, version);
+	queue.last_node = response->id.src;
+
+	/* Even though we have been provided a `param_t * param`,
+		we still call `param_queue_apply()` to support replies which unexpectedly contain multiple parameters.
+		Although we are SOL if those unexpected parameters are not in the list.
+		Our own variant notifies watches and histories with the `param_t` it already found,
+		sparing us a second search of the list per parameter.
+		TODO Kevin: Make sure ParameterList accounts for this scenario. */
+	param_queue_apply_err_callback(&queue, from, verbose, NULL, NULL);
+
+	/* For now we tolerate possibly setting parameters twice,
+		as we have not had remote parameters with callbacks/side-effects yet.
+		Although it is possible, I have tested it.
+		We `assert()` that `pycsh_param_transaction_callback_pull()` is only used client-side.
+		So PyCSH parameter servers will only use `param_queue_apply()` to apply parameters,
+		meaning no worries about callbacks being set twice. */
+	pycsh_param_queue_apply_listless(&queue, param_list, from, true);
+
+	csp_buffer_free(response);
+}
+
 static void pycsh_param_pull_all_callback(csp_packet_t *response, int verbose, int version, pycsh_queue_apply_context_t * context) {
 
 	assert(context);
 
 	int from = response->id.src;
+	pycsh_stats_rx_bytes(response->length);
 	//csp_hex_dump("pull response", response->data, response->length);
 	//printf("From %d\n", from);
 
@@ -933,13 +1055,55 @@ static void pycsh_param_pull_all_callback(csp_packet_t *response, int verbose, i
 }
 
 
+/**
+ * @brief `param_transaction()` which also accounts the transaction in `pycsh.stats()`.
+ */
+static int pycsh_param_transaction(csp_packet_t *packet, int host, int timeout, param_transaction_callback_f callback, int verbose, int version, void * context) {
+
+	pycsh_stats_kind_e kind;
+	switch (packet->data[0]) {
+		case PARAM_PULL_ALL_REQUEST:
+		case PARAM_PULL_ALL_REQUEST_V2:
+			kind = PYCSH_STATS_PULL_ALL;
+			break;
+		case PARAM_PULL_REQUEST:
+		case PARAM_PULL_REQUEST_V2:
+			kind = PYCSH_STATS_PULL;
+			break;
+		default:
+			kind = PYCSH_STATS_PUSH;
+			break;
+	}
+
+	/* `packet` is freed by `param_transaction()` */
+	const uint32_t tx_bytes = packet->length;
+	pycsh_stats_rx_bytes_take();
+	const uint64_t start_us = pycsh_stats_now_us();
+
+	/* Callers with retry loops resolve `PYCSH_TIMEOUT_AUTO` themselves, to back off between attempts. */
+	timeout = pycsh_stats_resolve_timeout(timeout, host, 0, pycsh_dfl_timeout);
+
+	const int res = param_transaction(packet, host, timeout, callback, verbose, version, context);
+
+	pycsh_stats_record(host, kind, start_us, res < 0, tx_bytes, pycsh_stats_rx_bytes_take());
+	/* A pull all reply spans many packets, and there is nothing to time without an ack. */
+	if (res >= 0 && timeout > 0 && kind != PYCSH_STATS_PULL_ALL) {
+		pycsh_stats_rtt_sample(host, pycsh_stats_now_us() - start_us);
+	}
+	return res;
+}
+
+
 int pycsh_param_pull_all(int prio, int verbose, int host, uint32_t include_mask, uint32_t exclude_mask, int timeout, int version, PyObject * py_err_callback) {
 
 	if (!py_err_callback) {
 		int res;
+		const uint64_t start_us = pycsh_stats_now_us();
 		Py_BEGIN_ALLOW_THREADS;
 		res = param_pull_all(prio, verbose, host, include_mask, exclude_mask, timeout, version);
 		Py_END_ALLOW_THREADS;
+		/* `param_pull_all()` applies the reply itself, so received bytes are not known here. */
+		pycsh_stats_record(host, PYCSH_STATS_PULL_ALL, start_us, res < 0, 12, 0);
 		return res;
 	}
 
@@ -971,7 +1135,7 @@ int pycsh_param_pull_all(int prio, int verbose, int host, uint32_t include_mask,
 	packet->data32[2] = htobe32(exclude_mask);
 	packet->length = 12;
 	packet->id.pri = prio;
-	const int res = param_transaction(packet, host, timeout, (param_transaction_callback_f)pycsh_param_pull_all_callback, verbose, version, &context);
+	const int res = pycsh_param_transaction(packet, host, timeout, (param_transaction_callback_f)pycsh_param_pull_all_callback, verbose, version, &context);
 
 	if (context.threads_suspended) {
 		Py_BLOCK_THREADS;  /* Threads did not resume in callback. */
@@ -1013,7 +1177,7 @@ static int pycsh_param_push_single(const param_t *param, int offset, int prio, v
 
 	packet->length = queue.used + 2;
 	packet->id.pri = prio;
-	int result = param_transaction(packet, host, timeout, cb, verbose, version, &param_list);
+	int result = pycsh_param_transaction(packet, host, timeout, cb, verbose, version, &param_list);
 
 	if (result < 0) {
 		return -1;
@@ -1058,7 +1222,91 @@ static int pycsh_param_pull_single(const param_t *param, int offset, int prio, i
 
 	packet->length = queue.used + 2;
 	packet->id.pri = prio;
-	return param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, version, &param_list);
+	return pycsh_param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, version, &param_list);
+}
+
+
+/* Pull in progress, shared by all threads requesting the same (param, offset) from the same host meanwhile. */
+typedef struct inflight_pull_s {
+	struct inflight_pull_s * next;
+	const param_t * param;
+	int offset;
+	int host;
+	int version;
+	unsigned int refs;  // Threads holding this entry, the last one frees it.
+	bool done;
+	int result;
+	pthread_cond_t cond;
+} inflight_pull_t;
+
+static pthread_mutex_t inflight_lock = PTHREAD_MUTEX_INITIALIZER;
+static inflight_pull_t * inflight_pulls = NULL;
+
+static void inflight_pull_release(inflight_pull_t * pull) {
+	/* Caller must hold `inflight_lock` */
+	if (--pull->refs == 0) {
+		pthread_cond_destroy(&pull->cond);
+		free(pull);
+	}
+}
+
+/**
+ * @brief `pycsh_param_pull_single()` which joins an identical pull already in flight from another thread, rather than sending its own.
+ *
+ * Does not require the GIL, and should be called without it, so other threads may join.
+ */
+static int pycsh_param_pull_single_shared(const param_t *param, int offset, int prio, int verbose, int host, int timeout, int version) {
+
+	pthread_mutex_lock(&inflight_lock);
+
+	for (inflight_pull_t * pull = inflight_pulls; pull != NULL; pull = pull->next) {
+		if (pull->param != param || pull->offset != offset || pull->host != host || pull->version != version) {
+			continue;
+		}
+		/* The value is applied to `param` by the thread doing the pull, so we only need its result. */
+		pull->refs++;
+		while (!pull->done) {
+			pthread_cond_wait(&pull->cond, &inflight_lock);
+		}
+		const int result = pull->result;
+		inflight_pull_release(pull);
+		pthread_mutex_unlock(&inflight_lock);
+		return result;
+	}
+
+	inflight_pull_t * const pull = calloc(1, sizeof(*pull));
+	if (pull == NULL) {
+		pthread_mutex_unlock(&inflight_lock);
+		return pycsh_param_pull_single(param, offset, prio, verbose, host, timeout, version);
+	}
+	*pull = (inflight_pull_t){
+		.next = inflight_pulls,
+		.param = param,
+		.offset = offset,
+		.host = host,
+		.version = version,
+		.refs = 1,
+	};
+	pthread_cond_init(&pull->cond, NULL);
+	inflight_pulls = pull;
+	pthread_mutex_unlock(&inflight_lock);
+
+	const int result = pycsh_param_pull_single(param, offset, prio, verbose, host, timeout, version);
+
+	pthread_mutex_lock(&inflight_lock);
+	for (inflight_pull_t ** link = &inflight_pulls; *link != NULL; link = &(*link)->next) {
+		if (*link == pull) {
+			*link = pull->next;  // Later requests should pull anew.
+			break;
+		}
+	}
+	pull->result = result;
+	pull->done = true;
+	pthread_cond_broadcast(&pull->cond);
+	inflight_pull_release(pull);
+	pthread_mutex_unlock(&inflight_lock);
+
+	return result;
 }
 
 
@@ -1082,7 +1330,7 @@ static int pycsh_param_pull_queue(param_queue_t *queue, const param_t *params, u
 
 	packet->length = queue->used + 2;
 	packet->id.pri = prio;
-	return param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, version, &param_list);
+	return pycsh_param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, version, &param_list);
 }
 
 
@@ -1130,7 +1378,7 @@ static int pycsh_param_push_queue(param_queue_t *queue, int prio, int verbose, i
 
 	}
 
-	int result = param_transaction(packet, host, timeout, cb, verbose, queue->version, ack_with_pull_params);
+	int result = pycsh_param_transaction(packet, host, timeout, cb, verbose, queue->version, ack_with_pull_params);
 
 	if (result < 0) {
 		printf("push queue error\n");
@@ -1146,6 +1394,131 @@ static int pycsh_param_push_queue(param_queue_t *queue, int prio, int verbose, i
 }
 
 
+int pycsh_param_pull_queue_params(param_queue_t *queue, const param_t **params, size_t param_cnt, int verbose, int host, int timeout) {
+
+	if ((queue == NULL) || (queue->used == 0))
+		return 0;
+
+	csp_packet_t * packet = csp_buffer_get(PARAM_SERVER_MTU);
+	if (packet == NULL)
+		return -1;
+
+	if (queue->version == 2) {
+		packet->data[0] = PARAM_PULL_REQUEST_V2;
+	} else {
+		packet->data[0] = PARAM_PULL_REQUEST;
+	}
+	packet->data[1] = 0;
+
+	param_list_t param_list = {
+		.param_arr = params,
+		.cnt = param_cnt
+	};
+
+	memcpy(&packet->data[2], queue->buffer, queue->used);
+
+	packet->length = queue->used + 2;
+	packet->id.pri = CSP_PRIO_NORM;
+	return pycsh_param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, queue->version, &param_list);
+}
+
+int pycsh_param_push_queue_params(param_queue_t *queue, const param_t **params, size_t param_cnt, int verbose, int host, int timeout, bool ack_with_pull) {
+
+	param_list_t param_list = {
+		.param_arr = params,
+		.cnt = param_cnt
+	};
+
+	return pycsh_param_push_queue(queue, 0, verbose, host, timeout, 0, ack_with_pull ? &param_list : NULL);
+}
+
+
+double pycsh_param_get_double(const param_t * param, unsigned int i) {
+	param_t * const p = (param_t *)param;
+	switch (param->type) {
+		case PARAM_TYPE_UINT8:
+		case PARAM_TYPE_XINT8:
+			return param_get_uint8_array(p, i);
+		case PARAM_TYPE_UINT16:
+		case PARAM_TYPE_XINT16:
+			return param_get_uint16_array(p, i);
+		case PARAM_TYPE_UINT32:
+		case PARAM_TYPE_XINT32:
+			return param_get_uint32_array(p, i);
+		case PARAM_TYPE_UINT64:
+		case PARAM_TYPE_XINT64:
+			return param_get_uint64_array(p, i);
+		case PARAM_TYPE_INT8:
+			return param_get_int8_array(p, i);
+		case PARAM_TYPE_INT16:
+			return param_get_int16_array(p, i);
+		case PARAM_TYPE_INT32:
+			return param_get_int32_array(p, i);
+		case PARAM_TYPE_INT64:
+			return param_get_int64_array(p, i);
+		case PARAM_TYPE_FLOAT:
+			return param_get_float_array(p, i);
+		case PARAM_TYPE_DOUBLE:
+			return param_get_double_array(p, i);
+		default:
+			return 0;
+	}
+}
+
+
+int64_t pycsh_param_age_ms(const param_t * param) {
+
+	if (*param->node == 0 || param->timestamp == NULL || param->timestamp->tv_sec == 0) {
+		return -1;  /* Local parameters are always current, and remote ones without a timestamp have an unknown age. */
+	}
+
+	csp_timestamp_t now;
+	csp_clock_get_time(&now);
+
+	const int64_t age_ms = ((int64_t)now.tv_sec - param->timestamp->tv_sec) * 1000
+		+ ((int64_t)now.tv_nsec - param->timestamp->tv_nsec) / 1000000;
+
+	/* Timestamps from the future, when remote clocks are ahead of ours, are not trusted. */
+	return age_ms < 0 ? -1 : age_ms;
+}
+
+bool pycsh_param_is_fresh(const param_t * param, int host, unsigned int max_age_ms) {
+
+	if (max_age_ms == 0) {
+		return false;
+	}
+
+	/* The cached value is from `*param->node`, not `host` */
+	if (host != INT_MIN && host != *param->node) {
+		return false;
+	}
+
+	const int64_t age_ms = pycsh_param_age_ms(param);
+	if (age_ms < 0 || age_ms >= max_age_ms) {
+		return false;
+	}
+	if (param->array_size <= 1) {
+		return true;
+	}
+
+	/* Elements not covered by a partial update may be as old as the last whole update. */
+	pthread_mutex_lock(&param_whole_lock);
+	const param_whole_t * const slot = param_whole_slot(param);
+	const bool whole = slot->param == param && slot->node == *param->node && slot->id == param->id;
+	const csp_timestamp_t whole_timestamp = slot->timestamp;
+	pthread_mutex_unlock(&param_whole_lock);
+
+	if (!whole || whole_timestamp.tv_sec == 0) {
+		return false;
+	}
+
+	csp_timestamp_t now;
+	csp_clock_get_time(&now);
+	const int64_t whole_age_ms = ((int64_t)now.tv_sec - whole_timestamp.tv_sec) * 1000
+		+ ((int64_t)now.tv_nsec - whole_timestamp.tv_nsec) / 1000000;
+	return whole_age_ms >= 0 && whole_age_ms < max_age_ms;
+}
+
 /* Checks that the specified index is within bounds of the sequence index, raises IndexError if not.
    Supports Python backwards subscriptions, mutates the index to a positive value in such cases. */
 int _pycsh_util_index(int seqlen, int *index) {
@@ -1171,18 +1544,23 @@ PyObject * _pycsh_util_get_single(const param_t *param, const int offset_orig, i
 	} else
 		offset = -1;
 
-	if (autopull && (*param->node != 0)) {
+	if (autopull && (*param->node != 0) && !pycsh_param_is_fresh(param, host, pycsh_dfl_max_age)) {
 
 		bool no_reply = false;
 		Py_BEGIN_ALLOW_THREADS;
 		for (int i = 0; i < (retries > 0 ? retries : 1); i++) {
 			int param_pull_res;
-			param_pull_res = pycsh_param_pull_single(param, offset, CSP_PRIO_NORM, 1, (host != INT_MIN ? host : *param->node), timeout, paramver);
-			if (param_pull_res && i >= retries-1) {
+			const int dest = (host != INT_MIN ? host : *param->node);
+			param_pull_res = pycsh_param_pull_single_shared(param, offset, CSP_PRIO_NORM, 1, dest, pycsh_stats_resolve_timeout(timeout, dest, i, pycsh_dfl_timeout), paramver);
+			if (param_pull_res == 0) {
+				break;
+			}
+			if (i >= retries-1) {
 				no_reply = true;
 				break;
 			}
-		}	
+			pycsh_stats_retry(dest, PYCSH_STATS_PULL);
+		}
 		Py_END_ALLOW_THREADS;
 
 		if (no_reply) {
@@ -1335,7 +1713,7 @@ static int pycsh_param_pull_queue(param_queue_t *queue, uint8_t prio, int verbos
 
 	packet->length = queue->used + 2;
 	packet->id.pri = prio;
-	return param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, queue->version, NULL);
+	return pycsh_param_transaction(packet, host, timeout, pycsh_param_transaction_callback_pull, verbose, queue->version, NULL);
 
 }
 #endif
@@ -1464,7 +1842,7 @@ PyObject * _pycsh_util_get_array(const param_t *param, int autopull, int host, i
 
 	// Pull the value for every index using a queue (if we're allowed to),
 	// instead of pulling them individually.
-	if (autopull && *param->node != 0) {
+	if (autopull && *param->node != 0 && !pycsh_param_is_fresh(param, INT_MIN, pycsh_dfl_max_age)) {
 		#if 0  /* Pull array parameters with index -1, like CSH. We may change this in the future */
 		uint8_t queuebuffer[PARAM_SERVER_MTU] = {0};
 		param_queue_t queue = {0};
@@ -1478,10 +1856,14 @@ PyObject * _pycsh_util_get_array(const param_t *param, int autopull, int host, i
 		bool no_reply = false;
 		Py_BEGIN_ALLOW_THREADS;
 		for (int i = 0; i < (retries > 0 ? retries : 1); i++) {
-			if (pycsh_param_pull_single(param, -1, CSP_PRIO_NORM, 0, *param->node, timeout, paramver)) {
+			if (pycsh_param_pull_single_shared(param, -1, CSP_PRIO_NORM, 0, *param->node, pycsh_stats_resolve_timeout(timeout, *param->node, i, pycsh_dfl_timeout), paramver) == 0) {
+				break;
+			}
+			if (i >= retries-1) {
 				no_reply = true;
 				break;
 			}
+			pycsh_stats_retry(*param->node, PYCSH_STATS_PULL);
 		}
 		Py_END_ALLOW_THREADS;
 
@@ -1629,11 +2011,15 @@ static int _pycsh_param_pull_single_indexes(const param_t *param, PyObject *inde
 
     bool no_reply = false;
     Py_BEGIN_ALLOW_THREADS;
-    for (size_t i = 0; i < (retries > 0 ? retries : 1); i++) {
-        if (pycsh_param_pull_queue(&queue, param, 1, CSP_PRIO_NORM, verbose, host, timeout, paramver)) {
+    for (int i = 0; i < (retries > 0 ? retries : 1); i++) {
+        if (pycsh_param_pull_queue(&queue, param, 1, CSP_PRIO_NORM, verbose, host, pycsh_stats_resolve_timeout(timeout, host, i, pycsh_dfl_timeout), paramver) == 0) {
+            break;
+        }
+        if (i >= retries-1) {
             no_reply = true;
             break;
         }
+        pycsh_stats_retry(host, PYCSH_STATS_PULL);
     }
     Py_END_ALLOW_THREADS;
 
@@ -1799,7 +2185,7 @@ PyObject * _pycsh_util_get_array_indexes(const param_t *param, PyObject * indici
 	
 	// Pull the value for every index using a queue (if we're allowed to),
 	// instead of pulling them individually.
-	if (autopull && *param->node != 0) {
+	if (autopull && *param->node != 0 && !pycsh_param_is_fresh(param, host, pycsh_dfl_max_age)) {
         if (_pycsh_param_pull_single_indexes(param, indicies_raw, autopull, host, timeout, retries, paramver, -1)) {
             return NULL;
         }
@@ -2032,17 +2418,24 @@ int _pycsh_util_set_single(const param_t *param, PyObject *value, int offset, in
 	//	confirm that it still behaves like the original (especially for remote host parameters).
 	if (remote && (dest != 0)) {  // When allowed, set remote parameter immediately.
 
+		const int batched = pycsh_batch_add(param, offset, valuebuf, dest);
+		if (batched != 0) {
+			return (batched < 0) ? -4 : 0;  // Pushed when the active `pycsh.batch()` exits.
+		}
+
 		for (int i = 0; i < (retries > 0 ? retries : 1); i++) {
 			int param_push_res;
 			Py_BEGIN_ALLOW_THREADS;  // Only allow threads for remote parameters, as local ones could have Python callbacks.
-			param_push_res = pycsh_param_push_single(param, offset, 0, valuebuf, 1, dest, timeout, paramver, true);
+			param_push_res = pycsh_param_push_single(param, offset, 0, valuebuf, 1, dest, pycsh_stats_resolve_timeout(timeout, dest, i, pycsh_dfl_timeout), paramver, true);
 			Py_END_ALLOW_THREADS;
-			if (param_push_res < 0) {
-				if (i >= retries-1) {
-					PyErr_Format(PyExc_ConnectionError, "No response from node %d", dest);
-					return -2;
-				}
+			if (param_push_res >= 0) {
+				break;
+			}
+			if (i >= retries-1) {
+				PyErr_Format(PyExc_ConnectionError, "No response from node %d", dest);
+				return -2;
 			}
+			pycsh_stats_retry(dest, PYCSH_STATS_PUSH);
 		}
 
 		if (verbose > -1) {
@@ -2146,7 +2539,13 @@ int _pycsh_util_set_array(const param_t *param, PyObject *value, int host, int t
 	}
 	
 	if (host != 0) {
-		if (param_push_queue(&queue, 1, 0, host, 100, 0, false) < 0) {  // TODO Kevin: We should probably have a parameter for hwid here.
+		const uint64_t start_us = pycsh_stats_now_us();
+		int push_res;
+		Py_BEGIN_ALLOW_THREADS;  // `queue` is on our stack, so nobody else can touch it.
+			push_res = param_push_queue(&queue, 1, 0, host, 100, 0, false);  // TODO Kevin: We should probably have a parameter for hwid here.
+		Py_END_ALLOW_THREADS;
+		pycsh_stats_record(host, PYCSH_STATS_PUSH, start_us, push_res < 0, queue.used, 0);
+		if (push_res < 0) {
 			PyErr_Format(PyExc_ConnectionError, "No response from node %d", *param->node);
 			return -6;
 		}
@@ -2159,6 +2558,47 @@ int _pycsh_util_set_array(const param_t *param, PyObject *value, int host, int t
 	return 0;
 }
 
+int pycsh_parse_timeout(PyObject * timeout_in, void * timeout_out) {
+
+	if (timeout_in == Py_None) {
+		*(int *)timeout_out = PYCSH_TIMEOUT_AUTO;
+		return 1;
+	}
+
+	const int timeout = _PyLong_AsInt(timeout_in);
+	if (timeout == -1 && PyErr_Occurred()) {
+		return 0;
+	}
+	*(int *)timeout_out = timeout;
+	return 1;
+}
+
+int pycsh_check_cancel(PyObject * cancel) {
+
+	if (PyErr_CheckSignals() != 0) {
+		return -1;
+	}
+
+	if (cancel == NULL || cancel == Py_None) {
+		return 0;
+	}
+
+	PyObject * is_set AUTO_DECREF = PyObject_CallMethod(cancel, "is_set", NULL);
+	if (is_set == NULL) {
+		return -1;
+	}
+
+	const int cancelled = PyObject_IsTrue(is_set);
+	if (cancelled < 0) {
+		return -1;
+	}
+	if (cancelled) {
+		PyErr_SetString(PyExc_InterruptedError, "Operation cancelled");
+		return -1;
+	}
+	return 0;
+}
+
 int pycsh_parse_param_mask(PyObject * mask_in, uint32_t * mask_out) {
 
 	assert(mask_in != NULL);
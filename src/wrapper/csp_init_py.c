@@ -11,11 +11,15 @@
 #include <Python.h>
 
 #include <stdio.h>
+#include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <csp/csp.h>
 #include <csp/csp_id.h>
 
+#include <sched.h>
+#include <limits.h>
 #include <pthread.h>
 #include <param/param_server.h>
 #include <vmem/vmem_server.h>
@@ -34,6 +38,8 @@
 #include <ifaddrs.h>
 
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
+#include <pycsh/router_stats.h>
 
 #include "../csp_classes/iface.h"
 
@@ -54,8 +60,11 @@ bool csp_initialized() {
 void * py_router_task(void * param) {
     (void)param;
     Py_Initialize();  // We need to initialize the Python interpreter before CSP may call any PythonParameter callbacks.
+    pycsh_router_worker_register();
     while(1) {
-        csp_route_work();
+        const uint64_t start_us = pycsh_stats_now_us();
+        const int res = csp_route_work();
+        pycsh_router_record_work(start_us, res == CSP_ERR_NONE);
     }
     Py_Finalize();
 }
@@ -66,6 +75,108 @@ void * py_vmem_server_task(void * param) {
     return NULL;
 }
 
+/**
+ * @brief Build thread attributes from the scheduling arguments of `csp_init()`.
+ *
+ * @param cpus Iterable of CPU indexes to pin the thread to, or NULL/None to leave affinity alone.
+ * @param priority SCHED_FIFO priority, 0 for the default policy.
+ * @param stack_size Stack size in bytes, 0 for the default.
+ * @return 0 on success, -1 with an exception set (and `attr` destroyed) on invalid arguments.
+ */
+static int pycsh_thread_attr_init(pthread_attr_t * attr, PyObject * cpus, int priority, size_t stack_size) {
+
+    pthread_attr_init(attr);
+
+    if (stack_size > 0) {
+        if (stack_size < PTHREAD_STACK_MIN) {
+            PyErr_Format(PyExc_ValueError, "stack_size must be at least %d bytes", (int)PTHREAD_STACK_MIN);
+            pthread_attr_destroy(attr);
+            return -1;
+        }
+        pthread_attr_setstacksize(attr, stack_size);
+    }
+
+    if (priority != 0) {
+        const int prio_min = sched_get_priority_min(SCHED_FIFO);
+        const int prio_max = sched_get_priority_max(SCHED_FIFO);
+        if (priority < prio_min || priority > prio_max) {
+            PyErr_Format(PyExc_ValueError, "SCHED_FIFO priority must be between %d and %d", prio_min, prio_max);
+            pthread_attr_destroy(attr);
+            return -1;
+        }
+        const struct sched_param sched = {.sched_priority = priority};
+        pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(attr, SCHED_FIFO);
+        pthread_attr_setschedparam(attr, &sched);
+    }
+
+    if (cpus != NULL && cpus != Py_None) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+
+        PyObject * iter AUTO_DECREF = PyObject_GetIter(cpus);
+        if (iter == NULL) {
+            pthread_attr_destroy(attr);
+            return -1;  // TypeError is thrown
+        }
+        PyObject * item;
+        while ((item = PyIter_Next(iter)) != NULL) {
+            const long cpu = PyLong_AsLong(item);
+            Py_DECREF(item);
+            if (cpu == -1 && PyErr_Occurred()) {
+                pthread_attr_destroy(attr);
+                return -1;
+            }
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                PyErr_Format(PyExc_ValueError, "CPU index %ld is out of range", cpu);
+                pthread_attr_destroy(attr);
+                return -1;
+            }
+            CPU_SET(cpu, &cpuset);
+        }
+        if (PyErr_Occurred()) {
+            pthread_attr_destroy(attr);
+            return -1;
+        }
+        if (CPU_COUNT(&cpuset) == 0) {
+            PyErr_SetString(PyExc_ValueError, "CPU affinity must include at least one CPU");
+            pthread_attr_destroy(attr);
+            return -1;
+        }
+        pthread_attr_setaffinity_np(attr, sizeof(cpuset), &cpuset);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief pthread_create() with `attr`, falling back to default attributes when they are refused.
+ *
+ * SCHED_FIFO requires CAP_SYS_NICE (or an RLIMIT_RTPRIO), and CSP is already initialized when the threads are started,
+ * so an unprivileged process gets a RuntimeWarning and a default thread, rather than no router at all.
+ *
+ * @return 0 on success, -1 with an exception set.
+ */
+static int pycsh_thread_create(pthread_t * thread, const pthread_attr_t * attr, void *(*task)(void *), const char * name) {
+
+    int res = pthread_create(thread, attr, task, NULL);
+    if (res == 0) {
+        return 0;
+    }
+
+    if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "Could not apply the scheduling options of the %s thread: %s, using defaults", name, strerror(res)) < 0) {
+        return -1;
+    }
+
+    res = pthread_create(thread, NULL, task, NULL);
+    if (res != 0) {
+        errno = res;
+        PyErr_SetFromErrno(PyExc_OSError);
+        return -1;
+    }
+    return 0;
+}
+
 PyObject * pycsh_csh_csp_init(PyObject * self, PyObject * args, PyObject * kwds) {
     (void)self;
     if(true == csp_router_is_running()) {
@@ -77,12 +188,34 @@ PyObject * pycsh_csh_csp_init(PyObject * self, PyObject * args, PyObject * kwds)
     char * revision = NULL;
     int version = 2;
     int dedup = 3;
+    PyObject * router_cpus = NULL;
+    int router_priority = 0;
+    PyObject * vmem_cpus = NULL;
+    int vmem_priority = 0;
+    Py_ssize_t stack_size = 0;
 
-    static char *kwlist[] = {"host", "model", "revision", "version", "dedup", NULL};
+    static char *kwlist[] = {"host", "model", "revision", "version", "dedup", "router_cpus", "router_priority", "vmem_cpus", "vmem_priority", "stack_size", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zzzii:csp_init", kwlist, &hostname, &model, &revision, &version, &dedup))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zzziiOiOin:csp_init", kwlist, &hostname, &model, &revision, &version, &dedup,
+                                     &router_cpus, &router_priority, &vmem_cpus, &vmem_priority, &stack_size))
         return NULL;  // TypeError is thrown
 
+    if (stack_size < 0) {
+        PyErr_SetString(PyExc_ValueError, "stack_size must not be negative");
+        return NULL;
+    }
+
+    /* Validate the scheduling options before initializing CSP, which can't be undone. */
+    pthread_attr_t router_attr;
+    if (pycsh_thread_attr_init(&router_attr, router_cpus, router_priority, stack_size) < 0) {
+        return NULL;
+    }
+    pthread_attr_t vmem_attr;
+    if (pycsh_thread_attr_init(&vmem_attr, vmem_cpus, vmem_priority, stack_size) < 0) {
+        pthread_attr_destroy(&router_attr);
+        return NULL;
+    }
+
     static struct utsname info;
     uname(&info);
 
@@ -111,11 +244,22 @@ PyObject * pycsh_csh_csp_init(PyObject * self, PyObject * args, PyObject * kwds)
     csp_bind_callback(csp_service_handler, CSP_ANY);
     csp_bind_callback(param_serve, PARAM_PORT_SERVER);
 
+    /* A single router thread, because `csp_route_work()` assumes it is the only router task.
+        Connection lookup/allocation and the RDP state machine are not locked against concurrent routing. */
     static pthread_t router_handle;
     csp_router_set_running(true);
-    pthread_create(&router_handle, NULL, &py_router_task, NULL);
+    if (pycsh_thread_create(&router_handle, &router_attr, &py_router_task, "router") < 0) {
+        pthread_attr_destroy(&router_attr);
+        pthread_attr_destroy(&vmem_attr);
+        return NULL;
+    }
     static pthread_t vmem_server_handle;
-    pthread_create(&vmem_server_handle, NULL, &py_vmem_server_task, NULL);
+    const int vmem_res = pycsh_thread_create(&vmem_server_handle, &vmem_attr, &py_vmem_server_task, "vmem server");
+    pthread_attr_destroy(&router_attr);
+    pthread_attr_destroy(&vmem_attr);
+    if (vmem_res < 0) {
+        return NULL;
+    }
 
     csp_iflist_check_dfl();
 
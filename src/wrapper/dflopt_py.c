@@ -87,6 +87,35 @@ PyObject * pycsh_slash_timeout(PyObject * self, PyObject * args, PyObject * kwds
 	return Py_BuildValue("i", pycsh_dfl_timeout);
 }
 
+PyObject * pycsh_slash_max_age(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	int max_age = -1;
+	int verbose = pycsh_dfl_verbose;
+
+	static char *kwlist[] = {"max_age", "verbose", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ii:max_age", kwlist, &max_age, &verbose)) {
+		return NULL;  // TypeError is thrown
+	}
+
+	if (max_age == -1) {
+		if (verbose >= 2) {
+			printf("Default max age = %u\n", pycsh_dfl_max_age);
+		}
+	} else if (max_age < 0) {
+		PyErr_SetString(PyExc_ValueError, "max_age must be >= 0");
+		return NULL;
+	} else {
+		pycsh_dfl_max_age = max_age;
+		if (verbose >= 1) {
+			printf("Set default max age to %u\n", pycsh_dfl_max_age);
+		}
+	}
+
+	return Py_BuildValue("I", pycsh_dfl_max_age);
+}
+
 PyObject * pycsh_slash_verbose(PyObject * self, PyObject * args) {
 	(void)self;
 
@@ -14,4 +14,6 @@ PyObject * pycsh_slash_node(PyObject * self, PyObject * args, PyObject * kwds);
 
 PyObject * pycsh_slash_timeout(PyObject * self, PyObject * args, PyObject * kwds);
 
+PyObject * pycsh_slash_max_age(PyObject * self, PyObject * args, PyObject * kwds);
+
 PyObject * pycsh_slash_verbose(PyObject * self, PyObject * args);
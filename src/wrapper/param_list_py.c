@@ -10,7 +10,10 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
+#include <errno.h>
 #include <assert.h>
+#include <limits.h>
+#include <string.h>
 
 #include <param/param_string.h>
 #include <param/param_list.h>
@@ -18,8 +21,11 @@
 #include <pycsh/pycsh.h>
 #include <pycsh/utils.h>
 #include <pycsh/parameter.h>
+#include <pycsh/param_index.h>
+#include <pycsh/param_cache.h>
 
 #include "param_list_py.h"
+#include "../parameter/parameterlistview.h"
 
 PyObject * pycsh_param_list(PyObject * self, PyObject * args, PyObject * kwds) {
     (void)self;
@@ -28,10 +34,11 @@ PyObject * pycsh_param_list(PyObject * self, PyObject * args, PyObject * kwds) {
     int verbosity = 1;
     PyObject * mask_obj = NULL;
     char * globstr = NULL;
+    int lazy = false;
 
-    static char *kwlist[] = {"node", "verbose", "mask", "globstr", NULL};
+    static char *kwlist[] = {"node", "verbose", "mask", "globstr", "lazy", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iiOz:list", kwlist, &node, &verbosity, &mask_obj, &globstr)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iiOzp:list", kwlist, &node, &verbosity, &mask_obj, &globstr, &lazy)) {
         return NULL;
     }
 
@@ -47,6 +54,10 @@ PyObject * pycsh_param_list(PyObject * self, PyObject * args, PyObject * kwds) {
         param_list_print(mask, node, globstr, verbosity);
     }
 
+    if (lazy) {
+        return ParameterListView_from_list(mask, node, globstr);
+    }
+
     return pycsh_util_parameter_list(mask, node, globstr);
 }
 
@@ -59,18 +70,57 @@ PyObject * pycsh_param_list_download(PyObject * self, PyObject * args, PyObject
     unsigned int timeout = pycsh_dfl_timeout;
     unsigned int version = 3;
     int include_remotes = false;
+    char * cache_dir = NULL;
+    char * cache_key = NULL;
+    unsigned int cache_max_age = 24*60*60;
 
-    static char *kwlist[] = {"node", "timeout", "version", "remote", NULL};
+    static char *kwlist[] = {"node", "timeout", "version", "remote", "cache", "cache_key", "cache_max_age", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|IIIp:list_download", kwlist, &node, &timeout, &version, &include_remotes)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|IIIpzzI:list_download", kwlist, &node, &timeout, &version, &include_remotes, &cache_dir, &cache_key, &cache_max_age)) {
         return NULL;  // TypeError is thrown
     }
 
+    /* The cache only holds parameters of `node`, so it can't stand in for `remote=True`. */
+    const bool use_cache = cache_dir != NULL && !include_remotes;
+    char cache_path[PATH_MAX];
+    char fingerprint[PARAM_CACHE_FINGERPRINT_LEN] = "";
+
+    if (use_cache) {
+        if (snprintf(cache_path, sizeof(cache_path), "%s/%u.pycshlist", cache_dir, node) >= (int)sizeof(cache_path)) {
+            PyErr_SetString(PyExc_ValueError, "Cache path too long");
+            return NULL;
+        }
+
+        int fingerprint_res;
+        Py_BEGIN_ALLOW_THREADS;
+        fingerprint_res = pycsh_param_cache_fingerprint(node, timeout, fingerprint, sizeof(fingerprint));
+        Py_END_ALLOW_THREADS;
+
+        /* Ident doesn't change with the list, so include the checksum provided by the caller. */
+        if (fingerprint_res == 0 && cache_key != NULL) {
+            const size_t len = strlen(fingerprint);
+            if (snprintf(&fingerprint[len], sizeof(fingerprint) - len, " %s", cache_key) >= (int)(sizeof(fingerprint) - len)) {
+                PyErr_Format(PyExc_ValueError, "cache_key too long, the fingerprint is limited to %d bytes", PARAM_CACHE_FINGERPRINT_LEN - 1);
+                return NULL;
+            }
+        }
+
+        /* No ident reply means we can't tell whether the cache is stale, let the download fail or succeed instead. */
+        if (fingerprint_res == 0) {
+            const int cached = pycsh_param_cache_load(cache_path, node, fingerprint, cache_max_age);
+            if (cached > 0) {
+                pycsh_param_index_invalidate();
+                return pycsh_util_parameter_list(0xFFFFFFFF, node, NULL);
+            }
+        }
+    }
+
     {  /* Allow threads during list_download() */
         int list_download_res;
         Py_BEGIN_ALLOW_THREADS;
         list_download_res = param_list_download(node, timeout, version, include_remotes);
         Py_END_ALLOW_THREADS;
+        pycsh_param_index_invalidate();
         // TODO Kevin: Downloading parameters with an incorrect version, can lead to a segmentation fault.
         //	Had it been easier to detect when an incorrect version is used, we would've raised an exception instead.
         if (list_download_res < 1) {  // We assume a connection error has occurred if we don't receive any parameters.
@@ -79,6 +129,14 @@ PyObject * pycsh_param_list_download(PyObject * self, PyObject * args, PyObject
         }
     }
 
+    if (use_cache && fingerprint[0] != '\0') {
+        if (pycsh_param_cache_save(cache_path, node, fingerprint) < 0) {
+            if (PyErr_WarnFormat(PyExc_RuntimeWarning, 1, "Failed to save parameter list cache '%s': %s", cache_path, strerror(errno)) < 0) {
+                return NULL;
+            }
+        }
+    }
+
     return pycsh_util_parameter_list(0xFFFFFFFF, node, NULL);
 
 }
@@ -151,6 +209,7 @@ PyObject * pycsh_param_list_add(PyObject * self, PyObject * args, PyObject * kwd
 
     bool wrap_existing = false;
     const int _list_add_res = param_list_add(param);
+    pycsh_param_index_invalidate();
     switch (_list_add_res) {
         case 1: {  /* Updated existing parameter */
             param_list_destroy(param);
@@ -236,6 +295,11 @@ int param_list_remove_py(int node, uint8_t verbose) {
 		}
 	}
 
+    if (count > 0) {
+        /* The index would otherwise point to the `param_t`s we just destroyed. */
+        pycsh_param_index_invalidate();
+    }
+
 	return count;
 }
 
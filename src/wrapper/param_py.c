@@ -38,7 +38,7 @@ PyObject * pycsh_param_get(PyObject * self, PyObject * args, PyObject * kwds) {
 
 	static char *kwlist[] = {"param_identifier", "node", "server", "paramver", "offset", "timeout", "retries", "verbose", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OiiOiii:get", kwlist, &param_identifier, &node, &server, &paramver, &offset, &timeout, &retries, &verbose))
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|OiiOO&ii:get", kwlist, &param_identifier, &node, &server, &paramver, &offset, pycsh_parse_timeout, &timeout, &retries, &verbose))
 		return NULL;  // TypeError is thrown
 
 	const param_t *param = _pycsh_util_find_param_t_hostname(param_identifier, node);
@@ -78,7 +78,7 @@ PyObject * pycsh_param_set(PyObject * self, PyObject * args, PyObject * kwds) {
 
 	static char *kwlist[] = {"param_identifier", "value", "node", "server", "paramver", "offset", "timeout", "retries", "verbose", NULL};
 	
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|Oiiiiii:set", kwlist, &param_identifier, &value, &node, &server, &paramver, &offset, &timeout, &retries, &verbose)) {
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|OiiiO&ii:set", kwlist, &param_identifier, &value, &node, &server, &paramver, &offset, pycsh_parse_timeout, &timeout, &retries, &verbose)) {
 		return NULL;  // TypeError is thrown
 	}
 
@@ -1,5 +1,6 @@
 #include "slash_py.h"
 #include <slash/slash.h>
+#include <pycsh/param_index.h>
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
@@ -40,5 +41,10 @@ PyObject * pycsh_slash_execute(PyObject * self, PyObject * args, PyObject * kwds
     char hist_buf[HISTORY_SIZE];
     slash_create_static(&slas, line_buf, LINE_SIZE, hist_buf, HISTORY_SIZE);
 
-    return Py_BuildValue("i", slash_execute(&slas, command));
+    const int ret = slash_execute(&slas, command);
+
+    /* Commands like "list forget" and "list download" modify the parameter list behind our back. */
+    pycsh_param_index_invalidate();
+
+    return Py_BuildValue("i", ret);
 }
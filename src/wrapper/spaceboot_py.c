@@ -11,6 +11,7 @@
 #include <pycsh/pycsh.h>
 
 #include "spaceboot_py.h"
+#include "vmem_client_py.h"
 
 #include <stdio.h>
 #include <stdbool.h>
@@ -20,6 +21,8 @@
 #include <string.h>
 #include <param/param.h>
 #include <pycsh/utils.h>
+#include <pycsh/param_index.h>
+#include <pycsh/crc32c.h>
 #include <param/param_list.h>
 #include <param/param_client.h>
 
@@ -30,18 +33,26 @@
 
 #include <csp/csp.h>
 #include <csp/csp_cmp.h>
-#include <csp/csp_crc32.h>
 
 #include <apm/csh_api.h>
 #include <slash/dflopt.h>
 
+/* Default `chunk_size` of `program()` and `sps()`, so firmware transfers can be cancelled between chunks.
+	Each chunk is a separate RDP transfer, so this trades a connection setup per 256 KiB for responsiveness. */
+#define SPACEBOOT_DFL_CHUNK_SIZE (256*1024)
+
 /* Custom exceptions */
 PyObject * PyExc_ProgramDiffError;
 
+/* Must be called with the GIL held, which is released while waiting for a reply. */
 static int ping(int node) {
 
 	struct csp_cmp_message message = {0};
-	if (csp_cmp_ident(node, 3000, &message) != CSP_ERR_NONE) {
+	int res;
+	Py_BEGIN_ALLOW_THREADS;
+		res = csp_cmp_ident(node, 3000, &message);
+	Py_END_ALLOW_THREADS;
+	if (res != CSP_ERR_NONE) {
 		printf("Cannot ping system\n");
 		return -1;
 	}
@@ -49,7 +60,11 @@ static int ping(int node) {
 	return 0;
 }
 
-static int reset_to_flash(int node, int flash, int times, int ms, int verbose) {
+/**
+ * Must be called with the GIL held, which is released while waiting for the network and the reboot.
+ * @return 0 on success, -3 with an exception set when cancelled.
+ */
+static int reset_to_flash(int node, int flash, int times, int ms, int verbose, PyObject * cancel) {
 
 #define NUM_SLOTS 4
 
@@ -90,7 +105,11 @@ static int reset_to_flash(int node, int flash, int times, int ms, int verbose) {
 		param_queue_add(&queue, boot_img[i], 0, &zero);
 	}
 	param_queue_add(&queue, boot_img[flash], 0, &times);
-	if (param_push_queue(&queue, CSP_PRIO_NORM, 1, node, 1000, 0, false) < 0) {
+	int push_res;
+	Py_BEGIN_ALLOW_THREADS;
+		push_res = param_push_queue(&queue, CSP_PRIO_NORM, 1, node, 1000, 0, false);
+	Py_END_ALLOW_THREADS;
+	if (push_res < 0) {
 		/* TODO: Ideally we would error here.
 			But modules with only 2 slots will not reply when they see we try to set `boot_img2` and `boot_img3`,
 			even though they successfully set `boot_img0` and `boot_img1`.
@@ -100,19 +119,33 @@ static int reset_to_flash(int node, int flash, int times, int ms, int verbose) {
 	}
 
 	printf("  Rebooting");
-	csp_reboot(node);
+	Py_BEGIN_ALLOW_THREADS;
+		csp_reboot(node);
+	Py_END_ALLOW_THREADS;
 	int step = 25;
+	bool cancelled = false;
 	while (ms > 0) {
 		printf(".");
 		fflush(stdout);
-		usleep(step * 1000);
+		Py_BEGIN_ALLOW_THREADS;
+			usleep(step * 1000);
+		Py_END_ALLOW_THREADS;
 		ms -= step;
+		if (pycsh_check_cancel(cancel) < 0) {
+			cancelled = true;
+			break;
+		}
 	}
 	printf("\n");
 
 	for (int i = 0; i < NUM_SLOTS; i++) {
 		if (!boot_img_exist[i]) param_list_remove_specific(boot_img[i], false, true);
 	}
+	pycsh_param_index_invalidate();
+
+	if (cancelled) {
+		return -3;
+	}
 
 	ping(node);
 
@@ -129,20 +162,24 @@ PyObject * slash_csp_switch(PyObject * self, PyObject * args, PyObject * kwds) {
 	unsigned int times = 1;
 	unsigned int reboot_delay = 1000;
 	int verbose = pycsh_dfl_verbose;
+	PyObject * cancel = NULL;
 
-    static char *kwlist[] = {"slot", "node", "times", "reboot_delay", "verbose", NULL};
+    static char *kwlist[] = {"slot", "node", "times", "reboot_delay", "verbose", "cancel", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|IIIi:switch", kwlist, &slot, &node, &times, &reboot_delay, &verbose))
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "I|IIIiO:switch", kwlist, &slot, &node, &times, &reboot_delay, &verbose, &cancel))
 		return NULL;  // TypeError is thrown
 
-	if (reset_to_flash(node, slot, times, reboot_delay, verbose) != 0) {
-        PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+	if (reset_to_flash(node, slot, times, reboot_delay, verbose, cancel) != 0) {
+		if (!PyErr_Occurred()) {
+			PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+		}
         return NULL;
     }
 
 	Py_RETURN_NONE;
 }
 
+/* Blocks on the network, call without holding the GIL. */
 static vmem_list_t vmem_list_find(int node, int timeout, char * name, int namelen) {
 	vmem_list_t ret = {0};
 
@@ -314,14 +351,26 @@ static bool is_valid_binary(const char * path, struct bin_info_t * binf, bin_fil
 	return ident_found;
 }
 
-static int upload_and_verify(int node, int address, char * data, int len) {
+/**
+ * Must be called with the GIL held, which is released during the transfers.
+ * @param chunk_size Bytes per transfer, between which `cancel` is checked. 0 for one transfer each way.
+ * @return 0 on success, -1 on mismatch, -2 with an exception set when cancelled.
+ */
+static int upload_and_verify(int node, int address, char * data, int len, uint32_t chunk_size, PyObject * cancel) {
 
 	unsigned int timeout = 10000;
 	printf("  Upload %u bytes to node %u addr 0x%x\n", len, node, address);
-	vmem_upload(node, timeout, address, data, len, 1);
+	pycsh_vmem_upload_chunked(node, timeout, address, data, len, 1, chunk_size, cancel);
+	if (PyErr_Occurred()) {
+		return -2;
+	}
 
 	char * datain = malloc(len);
-	vmem_download(node, timeout, address, len, datain, 1, 1);
+	pycsh_vmem_download_chunked(node, timeout, address, len, datain, 1, 1, chunk_size, cancel);
+	if (PyErr_Occurred()) {
+		free(datain);
+		return -2;
+	}
 
 	for (int i = 0; i < len; i++) {
 		if (datain[i] == data[i])
@@ -381,6 +430,8 @@ PyObject * pycsh_csh_program(PyObject * self, PyObject * args, PyObject * kwds)
 	unsigned int node = pycsh_dfl_node;
 
 	int do_crc32 = false;
+	unsigned int chunk_size = SPACEBOOT_DFL_CHUNK_SIZE;
+	PyObject * cancel = NULL;
 
 	/* RDPOPT - Keyword-only */
 	rdp_tmp_window = rdp_dfl_window;
@@ -390,9 +441,9 @@ PyObject * pycsh_csh_program(PyObject * self, PyObject * args, PyObject * kwds)
 	rdp_tmp_ack_timeout = rdp_dfl_ack_timeout;
 	rdp_tmp_ack_count = rdp_dfl_ack_count;
 
-    static char *kwlist[] = {"slot", "filename", "node", "do_crc32", RDP_KWARGS, NULL};
+    static char *kwlist[] = {"slot", "filename", "node", "do_crc32", RDP_KWARGS, "chunk_size", "cancel", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "Is|Ip$"RDP_TYPESTR":program", kwlist, &slot, &filename, &node, &do_crc32, RDP_OPTS))
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "Is|Ip$"RDP_TYPESTR"IO:program", kwlist, &slot, &filename, &node, &do_crc32, RDP_OPTS, &chunk_size, &cancel))
 		return NULL;  // TypeError is thrown
 
 	/* Temporarily set RDP options */
@@ -404,7 +455,10 @@ PyObject * pycsh_csh_program(PyObject * self, PyObject * args, PyObject * kwds)
 
 	printf("  Requesting VMEM name: %s...\n", vmem_name);
 
-	vmem_list_t vmem = vmem_list_find(node, 5000, vmem_name, strlen(vmem_name));
+	vmem_list_t vmem;
+	Py_BEGIN_ALLOW_THREADS;
+		vmem = vmem_list_find(node, 5000, vmem_name, strlen(vmem_name));
+	Py_END_ALLOW_THREADS;
 	if (vmem.size == 0) {
 		PyErr_SetString(PyExc_ConnectionError, "Failed to find vmem on subsystem\n");
 		return NULL;
@@ -446,12 +500,20 @@ PyObject * pycsh_csh_program(PyObject * self, PyObject * args, PyObject * kwds)
 
 	if (do_crc32) {
 		uint32_t crc;
-		crc = csp_crc32_memory((const uint8_t *)data, len);
+		Py_BEGIN_ALLOW_THREADS;
+			crc = pycsh_crc32c(0, data, len);
+		Py_END_ALLOW_THREADS;
 		printf("  File CRC32: 0x%08"PRIX32"\n", crc);
 		printf("  Upload %u bytes to node %u addr 0x%"PRIX32"\n", len, node, vmem.vaddr);
-		vmem_upload(node, 10000, vmem.vaddr, data, len, 1);
+		pycsh_vmem_upload_chunked(node, 10000, vmem.vaddr, data, len, 1, chunk_size, cancel);
+		if (PyErr_Occurred()) {
+			return NULL;  // Cancelled
+		}
 		uint32_t crc_node;
-		int res = vmem_client_calc_crc32(node, 10000, vmem.vaddr, len, &crc_node, 1);
+		int res;
+		Py_BEGIN_ALLOW_THREADS;
+			res = vmem_client_calc_crc32(node, 10000, vmem.vaddr, len, &crc_node, 1);
+		Py_END_ALLOW_THREADS;
 		if (res < 0) {
 			printf("\033[31m\n");
 			printf("  Communication failure: %"PRId32"\n", res);
@@ -474,8 +536,10 @@ PyObject * pycsh_csh_program(PyObject * self, PyObject * args, PyObject * kwds)
 		Py_RETURN_NONE;
 	}
 
-	if (upload_and_verify(node, vmem.vaddr, data, len) != 0) {
-		PyErr_SetString(PyExc_ProgramDiffError, "Diff during download (upload/download mismatch)");
+	if (upload_and_verify(node, vmem.vaddr, data, len, chunk_size, cancel) != 0) {
+		if (!PyErr_Occurred()) {
+			PyErr_SetString(PyExc_ProgramDiffError, "Diff during download (upload/download mismatch)");
+		}
 		return NULL;
 	}
 
@@ -493,6 +557,8 @@ PyObject * slash_sps(PyObject * self, PyObject * args, PyObject * kwds) {
 	unsigned int node = pycsh_dfl_node;
 	unsigned int reboot_delay = 1000;
 	int verbose = pycsh_dfl_verbose;
+	unsigned int chunk_size = SPACEBOOT_DFL_CHUNK_SIZE;
+	PyObject * cancel = NULL;
 
 	/* RDPOPT - Keyword-only */
 	rdp_tmp_window = rdp_dfl_window;
@@ -502,9 +568,9 @@ PyObject * slash_sps(PyObject * self, PyObject * args, PyObject * kwds) {
 	rdp_tmp_ack_timeout = rdp_dfl_ack_timeout;
 	rdp_tmp_ack_count = rdp_dfl_ack_count;
 
-    static char *kwlist[] = {"from_", "to", "filename", "node", "reboot_delay", "verbose", RDP_KWARGS, NULL};
+    static char *kwlist[] = {"from_", "to", "filename", "node", "reboot_delay", "verbose", RDP_KWARGS, "chunk_size", "cancel", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "IIs|IIi$"RDP_TYPESTR":sps", kwlist, &from, &to, &filename, &node, &reboot_delay, &verbose, RDP_OPTS)) {	
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "IIs|IIi$"RDP_TYPESTR"IO:sps", kwlist, &from, &to, &filename, &node, &reboot_delay, &verbose, RDP_OPTS, &chunk_size, &cancel)) {	
 		return NULL;  // TypeError is thrown
 	}
 
@@ -512,8 +578,10 @@ PyObject * slash_sps(PyObject * self, PyObject * args, PyObject * kwds) {
 	rdp_opt_set();
 	void * rdp_cleanup __attribute__((cleanup(_auto_reset_rdp))) = NULL;
 
-	if (reset_to_flash(node, from, 1, reboot_delay, verbose) != 0) {
-        PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+	if (reset_to_flash(node, from, 1, reboot_delay, verbose, cancel) != 0) {
+		if (!PyErr_Occurred()) {
+			PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+		}
         return NULL;
     }
 
@@ -521,7 +589,10 @@ PyObject * slash_sps(PyObject * self, PyObject * args, PyObject * kwds) {
 	snprintf(vmem_name, 5, "fl%u", to);
 	printf("  Requesting VMEM name: %s...\n", vmem_name);
 
-	vmem_list_t vmem = vmem_list_find(node, 5000, vmem_name, strlen(vmem_name));
+	vmem_list_t vmem;
+	Py_BEGIN_ALLOW_THREADS;
+		vmem = vmem_list_find(node, 5000, vmem_name, strlen(vmem_name));
+	Py_END_ALLOW_THREADS;
 	if (vmem.size == 0) {
 		PyErr_SetString(PyExc_ConnectionError, "Failed to find vmem on subsystem\n");
 		return NULL;
@@ -561,14 +632,18 @@ PyObject * slash_sps(PyObject * self, PyObject * args, PyObject * kwds) {
 		return NULL;
 	}
 
-	int result = upload_and_verify(node, vmem.vaddr, data, len);
+	int result = upload_and_verify(node, vmem.vaddr, data, len, chunk_size, cancel);
 	if (result != 0) {
-        PyErr_SetString(PyExc_ProgramDiffError, "Diff during download (upload/download mismatch)");
+		if (!PyErr_Occurred()) {
+			PyErr_SetString(PyExc_ProgramDiffError, "Diff during download (upload/download mismatch)");
+		}
         return NULL;
 	}
 
-    if (reset_to_flash(node, to, 1, reboot_delay, verbose)) {
-        PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+    if (reset_to_flash(node, to, 1, reboot_delay, verbose, cancel)) {
+		if (!PyErr_Occurred()) {
+			PyErr_SetString(PyExc_ConnectionError, "Cannot ping system");
+		}
         return NULL;
     }
 
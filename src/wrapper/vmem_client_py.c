@@ -8,16 +8,86 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
+#include <time.h>
+#include <stdlib.h>
+
+#include <csp/csp_types.h>
 #include <vmem/vmem_server.h>
 #include <vmem/vmem_client.h>
 
 #include "vmem_client_py.h"
 
 #include <pycsh/utils.h>
+#include <pycsh/stats.h>
 #include "../csp_classes/vmem.h"
 
 #include <pycsh/pycsh.h>
 
+int pycsh_vmem_download_chunked(int node, int timeout, uint64_t address, uint32_t length, char * dataout, int version, int use_rdp, uint32_t chunk_size, PyObject * cancel) {
+
+	if (chunk_size == 0) {
+		chunk_size = length;
+	}
+
+	uint32_t received = 0;
+	while (received < length) {
+
+		const uint32_t request = (length - received < chunk_size) ? length - received : chunk_size;
+		int res;
+		Py_BEGIN_ALLOW_THREADS;
+			res = vmem_download(node, timeout, address + received, request, dataout + received, version, use_rdp);
+		Py_END_ALLOW_THREADS;
+
+		if (res < 0) {
+			return res;
+		}
+		received += res;
+
+		if (pycsh_check_cancel(cancel) < 0) {
+			return received;
+		}
+
+		/* Short reads end the transfer, like they would without chunking. */
+		if ((uint32_t)res < request) {
+			break;
+		}
+	}
+
+	return received;
+}
+
+int pycsh_vmem_upload_chunked(int node, int timeout, uint64_t address, const char * datain, uint32_t length, int version, uint32_t chunk_size, PyObject * cancel) {
+
+	if (chunk_size == 0) {
+		chunk_size = length;
+	}
+
+	uint32_t sent = 0;
+	while (sent < length) {
+
+		const uint32_t request = (length - sent < chunk_size) ? length - sent : chunk_size;
+		int res;
+		Py_BEGIN_ALLOW_THREADS;
+			res = vmem_upload(node, timeout, address + sent, (char *)datain + sent, request, version);
+		Py_END_ALLOW_THREADS;
+
+		if (res < 0) {
+			return res;
+		}
+		sent += res;
+
+		if (pycsh_check_cancel(cancel) < 0) {
+			return sent;
+		}
+
+		if ((uint32_t)res < request) {
+			break;
+		}
+	}
+
+	return sent;
+}
+
 PyObject * pycsh_vmem_download(PyObject * self, PyObject * args, PyObject * kwds) {
 	(void)self;
 
@@ -39,10 +109,12 @@ PyObject * pycsh_vmem_download(PyObject * self, PyObject * args, PyObject * kwds
 	unsigned int ack_count = 2;
 	
 	int verbose = pycsh_dfl_verbose;
+	unsigned int chunk_size = 0;
+	PyObject * cancel = NULL;
 
-    static char *kwlist[] = {"address", "length", "node", "window", "conn_timeout", "packet_timeout", "ack_timeout", "ack_count", "timeout", "version", "use_rdp", "verbose", NULL};
+    static char *kwlist[] = {"address", "length", "node", "window", "conn_timeout", "packet_timeout", "ack_timeout", "ack_count", "timeout", "version", "use_rdp", "verbose", "chunk_size", "cancel", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "kI|IIIIIIIIpi:vmem_download", kwlist, &address, &length, &node, &window, &conn_timeout, &packet_timeout, &ack_timeout, &ack_count, &timeout, &version, &use_rdp, &verbose))
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "kI|IIIIIIIIpiIO:vmem_download", kwlist, &address, &length, &node, &window, &conn_timeout, &packet_timeout, &ack_timeout, &ack_count, &timeout, &version, &use_rdp, &verbose, &chunk_size, &cancel))
 		return NULL;  // TypeError is thrown
 
 	if (verbose > 1) {
@@ -59,7 +131,12 @@ PyObject * pycsh_vmem_download(PyObject * self, PyObject * args, PyObject * kwds
 		return PyErr_NoMemory();
 	}
 
-	const int received_len = vmem_download(node, timeout, address, length, odata, version, use_rdp);
+	const uint64_t start_us = pycsh_stats_now_us();
+	const int received_len = pycsh_vmem_download_chunked(node, timeout, address, length, odata, version, use_rdp, chunk_size, cancel);
+	pycsh_stats_record(node, PYCSH_STATS_VMEM, start_us, received_len < 0, 0, received_len > 0 ? received_len : 0);
+	if (PyErr_Occurred()) {
+		return NULL;  // Cancelled
+	}
 	if (received_len < 0) {
 		switch (received_len) {
 			case CSP_ERR_NOBUFS: {
@@ -151,10 +228,12 @@ PyObject * pycsh_vmem_upload(PyObject * self, PyObject * args, PyObject * kwds)
 	unsigned int ack_count = 2;
 
 	int verbose = pycsh_dfl_verbose;
+	unsigned int chunk_size = 0;
+	PyObject * cancel = NULL;
 
-    static char *kwlist[] = {"address", "data_in", "node", "window", "conn_timeout", "packet_timeout", "ack_timeout", "ack_count", "version", "verbose", NULL};
+    static char *kwlist[] = {"address", "data_in", "node", "window", "conn_timeout", "packet_timeout", "ack_timeout", "ack_count", "version", "verbose", "chunk_size", "cancel", NULL};
 
-	if (!PyArg_ParseTupleAndKeywords(args, kwds, "kO|kIIIIIIi:vmem_upload", kwlist, &address, &data_in, &node, &window, &conn_timeout, &packet_timeout, &ack_timeout, &ack_count, &version, &verbose)) {
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "kO|kIIIIIIiIO:vmem_upload", kwlist, &address, &data_in, &node, &window, &conn_timeout, &packet_timeout, &ack_timeout, &ack_count, &version, &verbose, &chunk_size, &cancel)) {
 		data_in = NULL;
 		return NULL;  // TypeError is thrown
 	}
@@ -188,9 +267,15 @@ PyObject * pycsh_vmem_upload(PyObject * self, PyObject * args, PyObject * kwds)
 
 	if (idata_len == 0 || idata == NULL) {
 		PyErr_SetString(PyExc_ValueError, "Nothing to upload");
+		return NULL;
 	}
 	
-	const int num_bytes_upload = vmem_upload(node, timeout, address, idata, idata_len, version);
+	const uint64_t start_us = pycsh_stats_now_us();
+	const int num_bytes_upload = pycsh_vmem_upload_chunked(node, timeout, address, idata, idata_len, version, chunk_size, cancel);
+	pycsh_stats_record(node, PYCSH_STATS_VMEM, start_us, num_bytes_upload < 0, num_bytes_upload > 0 ? num_bytes_upload : 0, 0);
+	if (PyErr_Occurred()) {
+		return NULL;  // Cancelled
+	}
 	if (num_bytes_upload < 0) {
 		
 		switch (num_bytes_upload) {
@@ -276,4 +361,286 @@ PyObject * pycsh_param_vmem(PyObject * self, PyObject * args, PyObject * kwds) {
 	csp_buffer_free(packet);
 
 	return list_string;
-}
\ No newline at end of file
+}
+
+/* Interface counters summed over all local interfaces, used to estimate RDP retransmissions. */
+typedef struct {
+	uint64_t tx;
+	uint64_t rx;
+	uint64_t drop;
+} iface_counters_t;
+
+static void iface_counters_get(iface_counters_t * out) {
+
+	*out = (iface_counters_t){0};
+
+	csp_iface_t * csp_iflist_iterate(csp_iface_t * ifc);
+
+	csp_iface_t * iface = NULL;
+	while ((iface = csp_iflist_iterate(iface)) != NULL) {
+		out->tx += iface->tx;
+		out->rx += iface->rx;
+		out->drop += iface->drop;
+	}
+}
+
+static double monotonic_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1E3 + ts.tv_nsec / 1E6;
+}
+
+static int compare_double(const void * a, const void * b) {
+	const double x = *(const double *)a;
+	const double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of an already sorted array. */
+static double percentile_sorted(const double * sorted, size_t cnt, double pct) {
+	if (cnt == 0) {
+		return 0;
+	}
+	size_t rank = (size_t)((pct / 100.0) * cnt + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > cnt) {
+		rank = cnt;
+	}
+	return sorted[rank-1];
+}
+
+#define RDP_SWEEP_MAX 32
+#define RDP_SWEEP_REPEAT_MAX 1000
+
+/* Defined by CSH, or weakly in spaceboot_py.c */
+extern unsigned int rdp_dfl_window;
+extern unsigned int rdp_dfl_conn_timeout;
+extern unsigned int rdp_dfl_packet_timeout;
+extern unsigned int rdp_dfl_delayed_acks;
+extern unsigned int rdp_dfl_ack_timeout;
+extern unsigned int rdp_dfl_ack_count;
+void rdp_opt_reset(void);
+
+static void _auto_reset_rdp(void ** stuff) {
+	(void)stuff;
+	rdp_opt_reset();
+}
+
+/**
+ * @brief Convert an int or an iterable of ints to a grid of RDP option values.
+ *
+ * @param obj int, iterable of int, or NULL to use `dfl`.
+ * @param dfl Value used when `obj` is NULL.
+ * @param grid Output array of at least RDP_SWEEP_MAX elements.
+ * @return size_t Number of values in the grid, or 0 with an exception set.
+ */
+static size_t rdp_grid_from_pyobject(PyObject * obj, unsigned int dfl, unsigned int grid[RDP_SWEEP_MAX]) {
+
+	if (obj == NULL) {
+		grid[0] = dfl;
+		return 1;
+	}
+
+	if (PyLong_Check(obj)) {
+		grid[0] = (unsigned int)PyLong_AsUnsignedLong(obj);
+		return PyErr_Occurred() ? 0 : 1;
+	}
+
+	PyObject * seq AUTO_DECREF = PySequence_Fast(obj, "RDP sweep values must be an int or an iterable of ints");
+	if (seq == NULL) {
+		return 0;
+	}
+
+	const Py_ssize_t cnt = PySequence_Fast_GET_SIZE(seq);
+	if (cnt <= 0 || cnt > RDP_SWEEP_MAX) {
+		PyErr_Format(PyExc_ValueError, "RDP sweep must contain between 1 and %d values per option", RDP_SWEEP_MAX);
+		return 0;
+	}
+
+	for (Py_ssize_t i = 0; i < cnt; i++) {
+		grid[i] = (unsigned int)PyLong_AsUnsignedLong(PySequence_Fast_GET_ITEM(seq, i));
+		if (PyErr_Occurred()) {
+			return 0;
+		}
+	}
+
+	return cnt;
+}
+
+PyObject * pycsh_vmem_benchmark(PyObject * self, PyObject * args, PyObject * kwds) {
+	(void)self;
+
+	CSP_INIT_CHECK()
+
+	uint64_t address;
+	unsigned int length;
+
+	unsigned int node = pycsh_dfl_node;
+	unsigned int timeout = pycsh_dfl_timeout;
+	unsigned int version = 1;
+	unsigned int conn_timeout = rdp_dfl_conn_timeout;
+	unsigned int repeat = 3;
+	int upload = 0;
+	int verbose = pycsh_dfl_verbose;
+
+	PyObject * windows_in = NULL;
+	PyObject * packet_timeouts_in = NULL;
+	PyObject * ack_timeouts_in = NULL;
+	PyObject * ack_counts_in = NULL;
+
+	static char *kwlist[] = {"address", "length", "node", "window", "packet_timeout", "ack_timeout", "ack_count", "conn_timeout", "repeat", "upload", "timeout", "version", "verbose", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "kI|IOOOOIIpIIi:vmem_benchmark", kwlist, &address, &length, &node, &windows_in, &packet_timeouts_in, &ack_timeouts_in, &ack_counts_in, &conn_timeout, &repeat, &upload, &timeout, &version, &verbose))
+		return NULL;  // TypeError is thrown
+
+	if (length == 0 || repeat == 0 || repeat > RDP_SWEEP_REPEAT_MAX) {
+		PyErr_Format(PyExc_ValueError, "`length` must be larger than 0, and `repeat` must be between 1 and %d", RDP_SWEEP_REPEAT_MAX);
+		return NULL;
+	}
+
+	unsigned int windows[RDP_SWEEP_MAX], packet_timeouts[RDP_SWEEP_MAX], ack_timeouts[RDP_SWEEP_MAX], ack_counts[RDP_SWEEP_MAX];
+	const size_t window_cnt = rdp_grid_from_pyobject(windows_in, rdp_dfl_window, windows);
+	const size_t packet_timeout_cnt = window_cnt ? rdp_grid_from_pyobject(packet_timeouts_in, rdp_dfl_packet_timeout, packet_timeouts) : 0;
+	const size_t ack_timeout_cnt = packet_timeout_cnt ? rdp_grid_from_pyobject(ack_timeouts_in, rdp_dfl_ack_timeout, ack_timeouts) : 0;
+	const size_t ack_count_cnt = ack_timeout_cnt ? rdp_grid_from_pyobject(ack_counts_in, rdp_dfl_ack_count, ack_counts) : 0;
+	if (ack_count_cnt == 0) {
+		return NULL;
+	}
+
+	double latencies[repeat];
+	char * const data CLEANUP_STR = malloc(length);
+	if (data == NULL) {
+		return PyErr_NoMemory();
+	}
+
+	/* Restores the default RDP options on every return. */
+	void * rdp_cleanup __attribute__((cleanup(_auto_reset_rdp))) = NULL;
+
+	/* Uploading writes back what we just read, so the sweep leaves the remote area unchanged. */
+	if (upload) {
+		int res;
+		csp_rdp_set_opt(rdp_dfl_window, conn_timeout, rdp_dfl_packet_timeout, rdp_dfl_delayed_acks, rdp_dfl_ack_timeout, rdp_dfl_ack_count);
+		Py_BEGIN_ALLOW_THREADS;
+			res = vmem_download(node, timeout, address, length, data, version, 1);
+		Py_END_ALLOW_THREADS;
+		if (res != (int)length) {
+			PyErr_Format(PyExc_ConnectionError, "Failed to download the area to upload (address=0x%"PRIX64"), (node=%u), (res=%d)", address, node, res);
+			return NULL;
+		}
+	}
+
+	PyObject * trials AUTO_DECREF = PyList_New(0);
+	if (trials == NULL) {
+		return NULL;
+	}
+
+	double min_packets = -1;
+	Py_ssize_t best_index = -1;
+	double best_throughput = 0;
+
+	for (size_t w = 0; w < window_cnt; w++)
+	for (size_t p = 0; p < packet_timeout_cnt; p++)
+	for (size_t a = 0; a < ack_timeout_cnt; a++)
+	for (size_t c = 0; c < ack_count_cnt; c++) {
+
+		const unsigned int window = windows[w];
+		const unsigned int packet_timeout = packet_timeouts[p];
+		const unsigned int ack_timeout = ack_timeouts[a];
+		const unsigned int ack_count = ack_counts[c];
+
+		if (verbose > 1) {
+			printf("Setting rdp options: %u %u %u %u %u\n", window, conn_timeout, packet_timeout, ack_timeout, ack_count);
+		}
+		csp_rdp_set_opt(window, conn_timeout, packet_timeout, rdp_dfl_delayed_acks, ack_timeout, ack_count);
+
+		size_t succeeded = 0;
+		unsigned int failed = 0;
+		iface_counters_t before, after;
+		iface_counters_get(&before);
+
+		for (unsigned int r = 0; r < repeat; r++) {
+
+			int res;
+			const double start = monotonic_ms();
+			Py_BEGIN_ALLOW_THREADS;
+				if (upload) {
+					res = vmem_upload(node, timeout, address, data, length, version);
+				} else {
+					res = vmem_download(node, timeout, address, length, data, version, 1);
+				}
+			Py_END_ALLOW_THREADS;
+			const double elapsed = monotonic_ms() - start;
+
+			if (res == (int)length) {
+				latencies[succeeded++] = elapsed;
+			} else {
+				failed++;
+			}
+
+			/* Allow Ctrl-C between transfers, a full sweep may take a long time. */
+			if (PyErr_CheckSignals() != 0) {
+				return NULL;
+			}
+		}
+
+		iface_counters_get(&after);
+
+		qsort(latencies, succeeded, sizeof(double), compare_double);
+		const double median = percentile_sorted(latencies, succeeded, 50);
+		const double throughput = (succeeded && median > 0) ? length / (median / 1E3) : 0;
+		const double packets = succeeded ? (double)((after.tx - before.tx) + (after.rx - before.rx)) / succeeded : 0;
+
+		if (succeeded && (min_packets < 0 || packets < min_packets)) {
+			min_packets = packets;
+		}
+
+		if (verbose > 0) {
+			printf("window %u packet_timeout %u ack_timeout %u ack_count %u: %.0f B/s, p50 %.1f ms, %u failed\n", window, packet_timeout, ack_timeout, ack_count, throughput, median, failed);
+		}
+
+		PyObject * trial AUTO_DECREF = Py_BuildValue("{s:I,s:I,s:I,s:I,s:I,s:n,s:I,s:d,s:{s:d,s:d,s:d,s:d,s:d},s:d,s:K}",
+			"window", window,
+			"conn_timeout", conn_timeout,
+			"packet_timeout", packet_timeout,
+			"ack_timeout", ack_timeout,
+			"ack_count", ack_count,
+			"succeeded", (Py_ssize_t)succeeded,
+			"failed", failed,
+			"throughput", throughput,
+			"latency_ms",
+				"min", succeeded ? latencies[0] : 0.0,
+				"p50", median,
+				"p90", percentile_sorted(latencies, succeeded, 90),
+				"p99", percentile_sorted(latencies, succeeded, 99),
+				"max", succeeded ? latencies[succeeded-1] : 0.0,
+			"packets", packets,
+			"drops", (unsigned long long)(after.drop - before.drop)
+		);
+		if (trial == NULL || PyList_Append(trials, trial) < 0) {
+			return NULL;
+		}
+
+		/* Only configurations that never failed are eligible for recommendation. */
+		if (failed == 0 && throughput > best_throughput) {
+			best_throughput = throughput;
+			best_index = PyList_GET_SIZE(trials) - 1;
+		}
+	}
+
+	/* The least packet-hungry configuration is our baseline,
+		packets exchanged beyond that (per transfer) are counted as retransmissions. */
+	for (Py_ssize_t i = 0; i < PyList_GET_SIZE(trials); i++) {
+		PyObject * trial = PyList_GET_ITEM(trials, i);  // borrowed
+		const double packets = PyFloat_AsDouble(PyDict_GetItemString(trial, "packets"));
+		PyObject * retransmissions AUTO_DECREF = PyFloat_FromDouble((min_packets >= 0 && packets > min_packets) ? packets - min_packets : 0.0);
+		if (retransmissions == NULL || PyDict_SetItemString(trial, "retransmissions", retransmissions) < 0) {
+			return NULL;
+		}
+	}
+
+	PyObject * recommended = best_index >= 0 ? PyList_GET_ITEM(trials, best_index) : Py_None;  // borrowed
+
+	return Py_BuildValue("{s:O,s:O}", "trials", trials, "recommended", recommended);
+}
@@ -10,6 +10,31 @@
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
 
+#include <stdint.h>
+
+/**
+ * @brief `vmem_download()` in chunks of `chunk_size`, without holding the GIL during transfers.
+ *
+ * Must be called with the GIL held. Checks `pycsh_check_cancel(cancel)` between chunks.
+ * Every chunk is a separate `vmem_download()`, and therefore a new (RDP) connection.
+ *
+ * @param chunk_size 0 downloads everything in one transfer.
+ * @return Number of bytes received, or a negative CSP error code. Check `PyErr_Occurred()` for cancellation.
+ */
+int pycsh_vmem_download_chunked(int node, int timeout, uint64_t address, uint32_t length, char * dataout, int version, int use_rdp, uint32_t chunk_size, PyObject * cancel);
+
+/**
+ * @brief `vmem_upload()` in chunks of `chunk_size`, without holding the GIL during transfers.
+ *
+ * Must be called with the GIL held. Checks `pycsh_check_cancel(cancel)` between chunks.
+ * Every chunk is a separate `vmem_upload()`, and therefore a new (RDP) connection.
+ *
+ * @param chunk_size 0 uploads everything in one transfer.
+ * @return Number of bytes uploaded, or a negative CSP error code. Check `PyErr_Occurred()` for cancellation.
+ */
+int pycsh_vmem_upload_chunked(int node, int timeout, uint64_t address, const char * datain, uint32_t length, int version, uint32_t chunk_size, PyObject * cancel);
+
 PyObject * pycsh_param_vmem(PyObject * self, PyObject * args, PyObject * kwds);
 PyObject * pycsh_vmem_download(PyObject * self, PyObject * args, PyObject * kwds);
-PyObject * pycsh_vmem_upload(PyObject * self, PyObject * args, PyObject * kwds);
\ No newline at end of file
+PyObject * pycsh_vmem_upload(PyObject * self, PyObject * args, PyObject * kwds);
+PyObject * pycsh_vmem_benchmark(PyObject * self, PyObject * args, PyObject * kwds);
\ No newline at end of file